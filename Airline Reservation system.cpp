@@ -2,17 +2,105 @@
 #include <vector>       
 #include <string>       
 #include <fstream>     
+#include <sstream>
 #include <iomanip>      
 #include <algorithm>    
 #include <chrono>      
 #include <random>       
 #include <limits>      
+#include <map>
+#include <unordered_map>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <string_view>
+#include <filesystem>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <iterator>
+#include <bitset>
+#include <charconv>
+#include <system_error>
+#include <array>
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <nmmintrin.h>
+#include <immintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 // Using namespace std for brevity. In larger projects, it's often preferred to qualify names (e.g., std::cout).
 using namespace std;
 
 // --- Struct Definitions for Data Organization ---
 
+/**
+ * @brief A reservation reference number packed into a 64-bit integer.
+ * Up to 8 characters are stored big-endian and padded with zero bytes, so the conversion to and
+ * from the printable form is lossless and comparing keys as integers orders them exactly like
+ * comparing the strings. Every generated reference ("RB" + 6 characters) fits.
+ */
+struct RefKey {
+    uint64_t value; // Packed characters; 0 is the empty reference number
+
+    RefKey() : value(0) {}
+    explicit RefKey(uint64_t packed) : value(packed) {}
+
+    /**
+     * @brief Packs a printable reference number.
+     * @param text The reference number as typed or stored.
+     * @param key Receives the packed key.
+     * @return False if the text is longer than 8 characters or contains a NUL byte.
+     */
+    static bool fromString(string_view text, RefKey& key) {
+        if (text.size() > 8) return false;
+        uint64_t packed = 0;
+        for (size_t i = 0; i < 8; ++i) {
+            unsigned char c = i < text.size() ? static_cast<unsigned char>(text[i]) : 0;
+            if (i < text.size() && c == 0) return false; // Would not survive the round trip
+            packed = (packed << 8) | c;
+        }
+        key.value = packed;
+        return true;
+    }
+
+    // Unpacks the key back into its printable form
+    string toString() const {
+        string text;
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            char c = static_cast<char>((value >> shift) & 0xFF);
+            if (c == 0) break;
+            text += c;
+        }
+        return text;
+    }
+
+    bool operator==(const RefKey& other) const { return value == other.value; }
+    bool operator!=(const RefKey& other) const { return value != other.value; }
+    bool operator<(const RefKey& other) const { return value < other.value; }
+    bool operator>(const RefKey& other) const { return value > other.value; }
+    bool operator<=(const RefKey& other) const { return value <= other.value; }
+    bool operator>=(const RefKey& other) const { return value >= other.value; }
+};
+
+// Reference numbers print in their printable form
+ostream& operator<<(ostream& out, const RefKey& key) {
+    return out << key.toString();
+}
+
 /**
  * @brief Represents a single passenger's details.
  * This struct helps organize related information about a passenger.
@@ -35,22 +123,130 @@ struct Passenger {
     }
 };
 
+struct PassengerRecord; // Binary snapshot layout, defined with the snapshot format
+
+/**
+ * @brief The passengers of a reservation; a drop-in replacement for vector<Passenger>.
+ * A list loaded in LoadMode::HeadersOnly only remembers where its PassengerRecords live in the
+ * memory-mapped snapshot (and keeps the mapping alive): size() is known immediately and the
+ * Passenger objects, with their strings, are decoded the first time the list is read.
+ * Decoding on a const list is safe while other threads copy it.
+ */
+class PassengerList {
+public:
+    using iterator = vector<Passenger>::iterator;
+    using const_iterator = vector<Passenger>::const_iterator;
+
+    PassengerList() {}
+    PassengerList(const PassengerList& other) { assign(other); }
+    PassengerList(PassengerList&& other) noexcept { take(other); }
+    PassengerList& operator=(const PassengerList& other) {
+        if (this != &other) assign(other);
+        return *this;
+    }
+    PassengerList& operator=(PassengerList&& other) noexcept {
+        if (this != &other) take(other);
+        return *this;
+    }
+
+    size_t size() const { return isDecoded() ? items.size() : lazyCount; }
+    bool empty() const { return size() == 0; }
+    bool isDecoded() const { return decoded.load(memory_order_acquire); }
+
+    const_iterator begin() const { decode(); return items.begin(); }
+    const_iterator end() const { decode(); return items.end(); }
+    iterator begin() { decode(); return items.begin(); }
+    iterator end() { decode(); return items.end(); }
+    const Passenger& operator[](size_t i) const { decode(); return items[i]; }
+    Passenger& operator[](size_t i) { decode(); return items[i]; }
+
+    // The i-th passenger's fields, read straight from the snapshot if the list is not decoded yet
+    string_view nameAt(size_t i) const;
+    string_view travelClassAt(size_t i) const;
+    int ageAt(size_t i) const;
+    int seatAt(size_t i) const;
+
+    void reserve(size_t count) { decode(); items.reserve(count); }
+    void push_back(const Passenger& p) { decode(); items.push_back(p); }
+    template <typename... Args>
+    void emplace_back(Args&&... args) { decode(); items.emplace_back(forward<Args>(args)...); }
+    void clear() {
+        items.clear();
+        release();
+    }
+
+    /**
+     * @brief Points the list at PassengerRecords in a snapshot mapping, to be decoded later.
+     * @param mapping Keeps the mapping alive for as long as the list needs it.
+     * @param records The first PassengerRecord.
+     * @param count Number of records.
+     * @param strings The segment's string pool.
+     * @param stringBytes Size of the string pool.
+     */
+    void attach(shared_ptr<const void> mapping, const PassengerRecord* records, size_t count, const char* strings, uint64_t stringBytes) {
+        items.clear();
+        owner = move(mapping);
+        lazyRecords = records;
+        lazyCount = count;
+        lazyStrings = strings;
+        lazyStringBytes = stringBytes;
+        decoded.store(count == 0, memory_order_release);
+    }
+
+private:
+    void decode() const; // Defined with the snapshot format
+
+    void release() {
+        owner.reset();
+        lazyRecords = nullptr;
+        lazyCount = 0;
+        decoded.store(true, memory_order_release);
+    }
+    void assign(const PassengerList& other) {
+        if (other.isDecoded()) {
+            items = other.items;
+            release();
+        } else {
+            items.clear();
+            attach(other.owner, other.lazyRecords, other.lazyCount, other.lazyStrings, other.lazyStringBytes);
+        }
+    }
+    void take(PassengerList& other) {
+        if (other.isDecoded()) {
+            items = move(other.items);
+            release();
+        } else {
+            attach(move(other.owner), other.lazyRecords, other.lazyCount, other.lazyStrings, other.lazyStringBytes);
+        }
+        other.clear();
+    }
+
+    mutable vector<Passenger> items;
+    mutable atomic<bool> decoded{ true };
+    shared_ptr<const void> owner;      // Keeps the snapshot mapping alive for decoding
+    const PassengerRecord* lazyRecords = nullptr;
+    size_t lazyCount = 0;
+    const char* lazyStrings = nullptr;
+    uint64_t lazyStringBytes = 0;
+};
+
 /**
  * @brief Represents a complete flight reservation.
  * This struct encapsulates all details for a booking, including multiple passengers.
  */
 struct Reservation {
-    string referenceNumber;     // Unique identifier for the reservation
+    RefKey referenceNumber;     // Unique identifier for the reservation, packed for integer comparisons
     string destination;         // Flight destination
     string departureTime;       // Scheduled departure time
+    string flightDate;          // Flight date as YYYY-MM-DD ("" for bookings made before dates were recorded)
     double totalPrice;          // Total cost of the reservation
     double discountApplied;     // Total discount given
-    vector<Passenger> passengers; // Dynamic array to store all passengers in this reservation
+    PassengerList passengers;   // Dynamic array to store all passengers in this reservation
     int numAdults;              // Count of adult passengers
     int numKids;                // Count of kid passengers
 
     // Default constructor for Reservation struct
-    Reservation() : referenceNumber(""), destination(""), departureTime(""), totalPrice(0.0), discountApplied(0.0), numAdults(0), numKids(0) {}
+    Reservation() : referenceNumber(), destination(""), departureTime(""), flightDate(""), totalPrice(0.0), discountApplied(0.0), numAdults(0), numKids(0) {}
 
     // Overload the equality operator for comparing Reservation objects (useful for searching)
     bool operator==(const Reservation& other) const {
@@ -72,6 +268,34 @@ vector<Reservation> allReservations; // Stores all reservations made in the syst
 string currentDestination;           // Temporarily stores the chosen destination
 string currentDepartureTime;         // Temporarily stores the chosen departure time
 
+// --- Persistence Settings ---
+const string SNAPSHOT_FILE = "reservations.dat"; // Binary snapshot (primary store)
+const string TEXT_FILE = "reservations.txt";     // Human-readable text format (import / export)
+const string WAL_FILE = "reservations.wal";      // Append-only log of bookings made since the last snapshot
+const string REF_INDEX_FILE = "reservations.idx"; // Sorted reference number -> snapshot offset index
+const string COLUMNAR_FILE = "reservations.col";  // Column-oriented export for analytics tools
+const string ARCHIVE_FILE = "reservations.arc";   // Compressed blocks of departed flights (cold tier)
+const string REF_FILTER_FILE = "reservations.bloom"; // Bloom filter over every reference number on disk
+
+/**
+ * @brief On-disk formats understood by saveReservations() / loadReservations().
+ */
+enum class StorageFormat {
+    Text,   // Line-based "REF:/DEST:/PASSENGER:" records
+    Binary  // Versioned, fixed-layout snapshot that can be memory-mapped
+};
+
+/**
+ * @brief How much of each reservation readSnapshot() builds up front.
+ */
+enum class LoadMode {
+    Full,       // Decode every passenger while loading
+    HeadersOnly // Load the reservation fields; passengers are decoded from the mapping on first access
+};
+
+// The store is loaded headers-only: reports, sorts and lookups rarely need passenger details
+const LoadMode STORE_LOAD_MODE = LoadMode::HeadersOnly;
+
 // --- Utility Functions ---
 
 /**
@@ -99,9 +323,9 @@ void pressAnyKey() {
 /**
  * @brief Generates a unique reference number for a reservation.
  * Uses a simple random string generation for demonstration.
- * @return A unique string reference number.
+ * @return A unique reference number, packed.
  */
-string generateReferenceNumber() {
+RefKey generateReferenceNumber() {
     static const char alphanumeric[] =
         "0123456789"
         "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
@@ -110,7 +334,72 @@ string generateReferenceNumber() {
     for (int i = 0; i < 6; ++i) {
         refNum += alphanumeric[rand() % (sizeof(alphanumeric) - 1)];
     }
-    return refNum;
+    RefKey key;
+    RefKey::fromString(refNum, key); // 8 characters always fit
+    return key;
+}
+
+/**
+ * @brief Reads a reference number typed by the user (one line).
+ * @param key Receives the packed reference number.
+ * @return False, after telling the user, if the input cannot be a reference number.
+ */
+bool readReferenceNumber(RefKey& key) {
+    string text;
+    getline(cin, text);
+    if (RefKey::fromString(text, key)) return true;
+    cout << "'" << text << "' is not a valid reference number.\n";
+    return false;
+}
+
+/**
+ * @brief Today's date in the format used for flight dates.
+ * @return The local date as YYYY-MM-DD.
+ */
+string todayDate() {
+    time_t now = time(nullptr);
+    tm local = *localtime(&now);
+    char buffer[11];
+    strftime(buffer, sizeof(buffer), "%Y-%m-%d", &local);
+    return buffer;
+}
+
+/**
+ * @brief Checks that a string is a real calendar date written as YYYY-MM-DD.
+ * @param date The text to check.
+ * @return True if the date is valid.
+ */
+bool isValidFlightDate(const string& date) {
+    if (date.size() != 10 || date[4] != '-' || date[7] != '-') return false;
+    for (size_t i : { 0, 1, 2, 3, 5, 6, 8, 9 }) {
+        if (!isdigit(static_cast<unsigned char>(date[i]))) return false;
+    }
+    int year = stoi(date.substr(0, 4));
+    int month = stoi(date.substr(5, 2));
+    int day = stoi(date.substr(8, 2));
+    static const int daysInMonth[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    if (month < 1 || month > 12) return false;
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return day >= 1 && day <= daysInMonth[month - 1] + ((month == 2 && leap) ? 1 : 0);
+}
+
+/**
+ * @brief Asks for the flight date until a valid date that is not in the past is entered.
+ * @return The date as YYYY-MM-DD.
+ */
+string askFlightDate() {
+    string date;
+    string today = todayDate();
+    cout << "\nEnter flight date (YYYY-MM-DD, today is " << today << ")\n";
+    do {
+        cin >> date;
+        if (!isValidFlightDate(date)) {
+            cout << "\n\n***** E R R O R *****\nEnter the date as YYYY-MM-DD\n*********************\n";
+        } else if (date < today) {
+            cout << "\n\n***** E R R O R *****\nThat flight has already departed\n*********************\n";
+        }
+    } while (!isValidFlightDate(date) || date < today);
+    return date;
 }
 
 /**
@@ -207,7 +496,7 @@ void displayBoardingPass(const Reservation& res) {
         cout << "\n        " << p.name;
         cout << "\n        Age " << p.age << "         Flight  RB370                   " << p.travelClass;
         cout << "\n        Seat " << p.seatNumber;
-        cout << "\n        KUALA LUMPUR to " << res.destination << "     " << res.departureTime << endl;
+        cout << "\n        KUALA LUMPUR to " << res.destination << "     " << res.departureTime << "  " << res.flightDate << endl;
     }
     cout << "\n        TOTAL AMOUNT : RM" << fixed << setprecision(2) << res.totalPrice;
     cout << "\n__________________________________________________________________________________________ \n";
@@ -298,6 +587,7 @@ Reservation createManualReservation() {
         else if (departureChoice == 'D') newReservation.departureTime = "10.30PM";
         else cout << "\nChoose (A / B / C / D) only\n";
     } while (departureChoice != 'A' && departureChoice != 'B' && departureChoice != 'C' && departureChoice != 'D');     
+    newReservation.flightDate = askFlightDate();
     clearScreen();
 
     // Coupon application
@@ -472,6 +762,7 @@ Reservation createPackageReservation(char packageChoice) {
         else if (departureChoice == 'D') newReservation.departureTime = "10.30PM";
         else cout << "\n\n***** E R R O R *****\nChoose (A / B / C / D) only\n*********************\n"; 
     } while (departureChoice != 'A' && departureChoice != 'B' && departureChoice != 'C' && departureChoice != 'D');
+    newReservation.flightDate = askFlightDate();
     clearScreen();              
 
     cout << "\n\nYou have completed your information and details\nTotal amount : RM" << fixed << setprecision(2) << newReservation.totalPrice << "\n";
@@ -489,210 +780,5171 @@ Reservation createPackageReservation(char packageChoice) {
 // --- File Handling Functions ---
 
 /**
- * @brief Saves all reservations to a file.
- * Each reservation and its passengers are written in a structured text format.
- * @param reservations The vector of Reservation objects to save.
- * @param filename The name of the file to save to.
+ * @brief Read-only memory mapping of a whole file.
+ * On POSIX systems the file is mapped with mmap so records can be used in place.
+ * Elsewhere the file is read into a private buffer, which keeps the same interface.
  */
-void saveReservations(const vector<Reservation>& reservations, const string& filename = "reservations.txt") {
-    ofstream outFile(filename); // Open file for writing
+class MappedFile {
+public:
+    MappedFile() {}
+    ~MappedFile() { close(); }
 
-    if (!outFile.is_open()) {
-        cerr << "Error: Could not open file " << filename << " for writing.\n";
-        return;
-    }
+    // A mapping owns OS resources, so it must not be copied
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
 
-    for (const auto& res : reservations) {
-        outFile << "REF:" << res.referenceNumber << "\n";
-        outFile << "DEST:" << res.destination << "\n";
-        outFile << "TIME:" << res.departureTime << "\n";
-        outFile << "PRICE:" << fixed << setprecision(2) << res.totalPrice << "\n";
-        outFile << "DISCOUNT:" << fixed << setprecision(2) << res.discountApplied << "\n";
-        outFile << "NUM_ADULTS:" << res.numAdults << "\n";
-        outFile << "NUM_KIDS:" << res.numKids << "\n";
-        outFile << "NUM_PASSENGERS:" << res.passengers.size() << "\n";
-        for (const auto& p : res.passengers) {
-            outFile << "PASSENGER:" << p.name << "," << p.age << "," << p.seatNumber << "," << p.travelClass << "\n";
+    /**
+     * @brief Maps the given file into memory.
+     * @param filename The file to map.
+     * @return True if the file was mapped (an empty file maps successfully with size 0).
+     */
+    bool open(const string& filename) {
+        close();
+#ifdef _WIN32
+        ifstream inFile(filename, ios::binary | ios::ate);
+        if (!inFile.is_open()) return false;
+        buffer.resize(static_cast<size_t>(inFile.tellg()));
+        inFile.seekg(0);
+        if (!buffer.empty() && !inFile.read(buffer.data(), buffer.size())) return false;
+        mappedData = buffer.data();
+        mappedSize = buffer.size();
+        return true;
+#else
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            return false;
         }
-        outFile << "END_RESERVATION\n"; // Marker for end of each reservation
+        mappedSize = static_cast<size_t>(st.st_size);
+        if (mappedSize > 0) {
+            void* addr = mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr == MAP_FAILED) {
+                ::close(fd);
+                mappedSize = 0;
+                return false;
+            }
+            mappedData = static_cast<const char*>(addr);
+        }
+        ::close(fd); // The mapping stays valid after the descriptor is closed
+        isMapped = true;
+        return true;
+#endif
     }
 
-    outFile.close(); // Close the file
-    // cout << "Reservations saved to " << filename << endl; // For debugging
+    // Releases the mapping (safe to call more than once)
+    void close() {
+#ifdef _WIN32
+        buffer.clear();
+#else
+        if (mappedData != nullptr) munmap(const_cast<char*>(mappedData), mappedSize);
+        isMapped = false;
+#endif
+        mappedData = nullptr;
+        mappedSize = 0;
+    }
+
+    const char* data() const { return mappedData; }
+    size_t size() const { return mappedSize; }
+
+private:
+    const char* mappedData = nullptr; // Start of the mapped bytes
+    size_t mappedSize = 0;            // Number of mapped bytes
+#ifdef _WIN32
+    vector<char> buffer;              // Private copy of the file contents
+#else
+    bool isMapped = false;            // True while a mapping is held
+#endif
+};
+
+/**
+ * @brief Flushes a stdio stream and forces its contents to stable storage.
+ * @return True if both the flush and the sync succeeded.
+ */
+bool syncFile(FILE* file) {
+    if (fflush(file) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
 }
 
 /**
- * @brief Loads reservations from a file.
- * Reads data in the structured text format.
- * @param filename The name of the file to load from.
- * @return A vector of loaded Reservation objects.
+ * @brief Replaces a file with a freshly written one.
+ * The new contents are written to "<filename>.tmp" first and then renamed over the target,
+ * so a crash never leaves a half-written file behind under the real name.
+ * @return True if the temporary file was written and renamed successfully.
  */
-vector<Reservation> loadReservations(const string& filename = "reservations.txt") {
-    vector<Reservation> loadedReservations;
-    ifstream inFile(filename); // Open file for reading
+bool replaceFile(const string& tempFilename, const string& filename) {
+#ifdef _WIN32
+    remove(filename.c_str()); // rename() does not overwrite on Windows
+#endif
+    return rename(tempFilename.c_str(), filename.c_str()) == 0;
+}
 
-    if (!inFile.is_open()) {
-        // cerr << "Warning: Could not open file " << filename << " for reading. Starting with empty data.\n"; // For debugging
-        return loadedReservations; // Return empty vector if file doesn't exist or can't be opened
-    }
+// --- CPU Feature Detection ---
 
-    string line;
-    Reservation currentRes;
-    while (getline(inFile, line)) {
-        if (line.rfind("REF:", 0) == 0) { // Starts with "REF:"
-            currentRes = Reservation(); // Reset for new reservation
-            currentRes.referenceNumber = line.substr(4);
-        } else if (line.rfind("DEST:", 0) == 0) {
-            currentRes.destination = line.substr(5);
-        } else if (line.rfind("TIME:", 0) == 0) {
-            currentRes.departureTime = line.substr(5);
-        } else if (line.rfind("PRICE:", 0) == 0) {
-            currentRes.totalPrice = stod(line.substr(6)); // Convert string to double
-        } else if (line.rfind("DISCOUNT:", 0) == 0) {
-            currentRes.discountApplied = stod(line.substr(9));
-        } else if (line.rfind("NUM_ADULTS:", 0) == 0) {
-            currentRes.numAdults = stoi(line.substr(11));
-        } else if (line.rfind("NUM_KIDS:", 0) == 0) {
-            currentRes.numKids = stoi(line.substr(9));
-        } else if (line.rfind("NUM_PASSENGERS:", 0) == 0) {
-            // Not strictly needed for loading, as passenger data is read directly below
-        } else if (line.rfind("PASSENGER:", 0) == 0) {
-            string passengerData = line.substr(10);
-            size_t pos1 = passengerData.find(',');
-            string name = passengerData.substr(0, pos1);
-            
-            size_t pos2 = passengerData.find(',', pos1 + 1);
-            int age = stoi(passengerData.substr(pos1 + 1, pos2 - (pos1 + 1)));
-            
-            size_t pos3 = passengerData.find(',', pos2 + 1);
-            int seat = stoi(passengerData.substr(pos2 + 1, pos3 - (pos2 + 1)));
-            
-            string travelClass = passengerData.substr(pos3 + 1);
-            
-            currentRes.passengers.emplace_back(name, age, seat, travelClass);
-        } else if (line == "END_RESERVATION") {
-            loadedReservations.push_back(currentRes);
-        }
-    }
+// Marks a function that may use SSE4.2 instructions even though the rest of the program is built
+// for the baseline instruction set; callers check the CPU at runtime before using it.
+#if defined(__GNUC__) || defined(__clang__)
+#define TARGET_SSE42 __attribute__((target("sse4.2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSE42
+#define TARGET_AVX2
+#endif
 
-    inFile.close();
-    // cout << "Reservations loaded from " << filename << endl; // For debugging
-    return loadedReservations;
+// True if the CPU supports SSE4.2 (crc32 instruction, 64-bit integer compares)
+bool cpuSupportsSse42() {
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    return __builtin_cpu_supports("sse4.2");
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 20)) != 0;
+#else
+    return false;
+#endif
 }
 
-// --- Sorting Algorithms ---
+// True if the CPU and operating system support AVX2 (256-bit integer compares)
+bool cpuSupportsAvx2() {
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    return __builtin_cpu_supports("avx2");
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int info[4];
+    __cpuid(info, 1);
+    bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 6) == 6; // OSXSAVE, and YMM state enabled
+    __cpuidex(info, 7, 0);
+    return osSavesYmm && (info[1] & (1 << 5)) != 0;
+#else
+    return false;
+#endif
+}
 
-/**
- * @brief Sorts a vector of reservations using Bubble Sort.
- * Compares adjacent elements and swaps them if they are in the wrong order.
- * Sorts by totalPrice in ascending order.
- * @param arr The vector of Reservation objects to sort.
- */
-void bubbleSort(vector<Reservation>& arr) {
-    int n = arr.size();
-    for (int i = 0; i < n - 1; ++i) {
-        for (int j = 0; j < n - i - 1; ++j) {
-            // Compare based on totalPrice
-            if (arr[j].totalPrice > arr[j+1].totalPrice) {
-                // Swap if the current element is greater than the next
-                swap(arr[j], arr[j+1]);
-            }
-        }
-    }
+// Hints the CPU to start loading the cache line holding address; never faults
+inline void prefetchRead(const void* address) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address, 0, 3);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+    (void)address;
+#endif
 }
 
-/**
- * @brief Merges two sorted sub-arrays into one.
- * Helper function for Merge Sort.
- * @param arr The main array containing the sub-arrays.
- * @param l The starting index of the first sub-array.
- * @param m The ending index of the first sub-array.
- * @param r The ending index of the second sub-array.
- */
-void merge(vector<Reservation>& arr, int l, int m, int r) {
-    int n1 = m - l + 1; // Size of left sub-array
-    int n2 = r - m;     // Size of right sub-array
+// Number of set bits in a 64-bit word
+inline int popcount64(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(word);
+#else
+    return static_cast<int>(bitset<64>(word).count());
+#endif
+}
 
-    // Create temporary arrays
-    vector<Reservation> L(n1);
-    vector<Reservation> R(n2);
+// Index of the lowest set bit of a non-zero 64-bit word
+inline int lowestBit64(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#else
+    return popcount64((word & (0 - word)) - 1);
+#endif
+}
 
-    // Copy data to temporary arrays
-    for (int i = 0; i < n1; ++i)
-        L[i] = arr[l + i];
-    for (int j = 0; j < n2; ++j)
-        R[j] = arr[m + 1 + j];
+// Size of the last-level cache in bytes, or 0 if it cannot be determined
+size_t lastLevelCacheBytes() {
+#if defined(__linux__) && defined(_SC_LEVEL3_CACHE_SIZE)
+    long bytes = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    if (bytes <= 0) bytes = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    return bytes > 0 ? static_cast<size_t>(bytes) : 0;
+#else
+    return 0;
+#endif
+}
 
-    // Merge the temporary arrays back into arr[l..r]
-    int i = 0; // Initial index of first sub-array
-    int j = 0; // Initial index of second sub-array
-    int k = l; // Initial index of merged sub-array
 
-    while (i < n1 && j < n2) {
-        // Compare based on totalPrice
-        if (L[i].totalPrice <= R[j].totalPrice) {
-            arr[k] = L[i];
-            i++;
-        } else {
-            arr[k] = R[j];
-            j++;
+// --- CRC32C Checksums ---
+//
+// Every persisted reservation record carries a CRC32C (Castagnoli polynomial) so a torn or damaged
+// write is detected on load. x86 CPUs with SSE4.2 compute it with the crc32 instruction; other
+// machines fall back to a slicing-by-8 table implementation. Both produce identical values.
+
+// Builds the 8 x 256 lookup tables for the software implementation
+struct Crc32cTables {
+    uint32_t table[8][256];
+
+    Crc32cTables() {
+        const uint32_t polynomial = 0x82F63B78; // Reflected Castagnoli polynomial
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) crc = (crc >> 1) ^ ((crc & 1) ? polynomial : 0);
+            table[0][i] = crc;
+        }
+        for (uint32_t i = 0; i < 256; ++i) {
+            for (int slice = 1; slice < 8; ++slice) {
+                table[slice][i] = (table[slice - 1][i] >> 8) ^ table[0][table[slice - 1][i] & 0xFF];
+            }
         }
-        k++;
     }
+};
 
-    // Copy remaining elements of L[], if any
-    while (i < n1) {
-        arr[k] = L[i];
-        i++;
-        k++;
+// Software CRC32C over raw state (no pre/post inversion), eight bytes per step
+uint32_t crc32cSoftware(uint32_t state, const char* data, size_t length) {
+    static const Crc32cTables tables;
+    const auto& t = tables.table;
+    while (length >= 8) {
+        uint64_t word;
+        memcpy(&word, data, 8);
+        uint32_t low = static_cast<uint32_t>(word) ^ state;
+        uint32_t high = static_cast<uint32_t>(word >> 32);
+        state = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24] ^
+                t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+        data += 8;
+        length -= 8;
     }
-
-    // Copy remaining elements of R[], if any
-    while (j < n2) {
-        arr[k] = R[j];
-        j++;
-        k++;
+    while (length-- > 0) {
+        state = (state >> 8) ^ t[0][(state ^ static_cast<uint8_t>(*data++)) & 0xFF];
     }
+    return state;
 }
 
-/**
- * @brief Sorts a vector of reservations using Merge Sort.
- * A recursive, divide-and-conquer sorting algorithm.
- * Sorts by totalPrice in ascending order.
- * @param arr The vector of Reservation objects to sort.
- * @param l The starting index of the sub-array to sort.
- * @param r The ending index of the sub-array to sort.
- */
-void mergeSort(vector<Reservation>& arr, int l, int r) {
-    if (l < r) {
-        int m = l + (r - l) / 2; // Find the middle point
-        mergeSort(arr, l, m);    // Sort first half
-        mergeSort(arr, m + 1, r); // Sort second half
-        merge(arr, l, m, r);     // Merge the sorted halves
-    }
-}
+#if defined(__x86_64__) || defined(_M_X64)
+#define HAVE_HARDWARE_CRC32C 1
 
-// Wrapper for mergeSort to be called easily
-void mergeSort(vector<Reservation>& arr) {
-    if (!arr.empty()) {
-        mergeSort(arr, 0, arr.size() - 1);
+// Hardware CRC32C over raw state using the SSE4.2 crc32 instruction
+TARGET_SSE42 uint32_t crc32cHardware(uint32_t state, const char* data, size_t length) {
+    uint64_t state64 = state;
+    while (length >= 8) {
+        uint64_t word;
+        memcpy(&word, data, 8);
+        state64 = _mm_crc32_u64(state64, word);
+        data += 8;
+        length -= 8;
     }
+    state = static_cast<uint32_t>(state64);
+    while (length-- > 0) state = _mm_crc32_u8(state, static_cast<uint8_t>(*data++));
+    return state;
 }
+#endif
 
-// --- Searching Algorithms ---
+// True if crc32c() uses the CPU's crc32 instruction
+bool hardwareCrc32cAvailable() {
+#ifdef HAVE_HARDWARE_CRC32C
+    static const bool available = cpuSupportsSse42();
+    return available;
+#else
+    return false;
+#endif
+}
 
 /**
- * @brief Searches for a reservation by reference number using Linear Search.
- * Checks each element sequentially until a match is found.
- * @param arr The vector of Reservation objects to search.
- * @param refNum The reference number to search for.
- * @return The index of the found reservation, or -1 if not found.
+ * @brief Computes (or continues) a CRC32C checksum.
+ * @param data The bytes to checksum.
+ * @param length Number of bytes.
+ * @param crc The checksum of the preceding bytes when checksumming in pieces (0 to start).
+ * @return The checksum of everything so far.
  */
-int linearSearch(const vector<Reservation>& arr, const string& refNum) {
-    for (int i = 0; i < arr.size(); ++i) {
-        if (arr[i].referenceNumber == refNum) {
-            return i; // Found at index i
-        }
+uint32_t crc32c(const void* data, size_t length, uint32_t crc = 0) {
+    const char* bytes = static_cast<const char*>(data);
+#ifdef HAVE_HARDWARE_CRC32C
+    if (hardwareCrc32cAvailable()) return ~crc32cHardware(~crc, bytes, length);
+#endif
+    return ~crc32cSoftware(~crc, bytes, length);
+}
+
+// --- Binary Snapshot Format ---
+//
+// reservations.dat is a sequence of segments (all integers little-endian as written by the host).
+// Each segment is laid out as:
+//   SnapshotHeader
+//   ReservationRecord[reservationCount]
+//   PassengerRecord[passengerCount]
+//   string pool (stringBytes of UTF-8 text, not null-terminated)
+// Offsets are relative to the start of the segment, every section starts on an 8-byte boundary so
+// records can be read in place from the mapping, and segmentBytes covers the whole padded segment.
+//
+// The first segment is a full image of the reservation list. Incremental saves append delta
+// segments holding only the reservations added or changed since the previous save; every record
+// carries its slot (position in the reservation list), so a delta record either replaces the
+// reservation already in that slot or appends a new one. Once deltas grow too large the file is
+// rewritten as a single full segment.
+//
+// Each segment header and each reservation record carries a CRC32C. A record's checksum covers the
+// record itself, its passenger records and its span of the string pool, so a torn or damaged
+// record is detected on load; loading stops cleanly at the first one.
+//
+// walSequence (taken from the last segment) records the last booking-log entry already contained in
+// the snapshot, so replaying the log after a crash between "snapshot written" and "log compacted"
+// never applies a booking twice.
+
+const char SNAPSHOT_MAGIC[8] = { 'R', 'B', 'S', 'N', 'A', 'P', '\0', '\0' };
+const uint32_t SNAPSHOT_VERSION = 6;
+const uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304; // Detects files written on a host with a different byte order
+
+enum SegmentKind : uint32_t {
+    SEGMENT_FULL = 0,  // Complete reservation list
+    SEGMENT_DELTA = 1  // Reservations added or changed since the previous segment
+};
+
+// Location of a string inside a segment's string pool
+struct StringRef {
+    uint32_t offset; // Byte offset from the start of the pool
+    uint32_t length; // Length in bytes
+};
+
+struct SnapshotHeader {
+    char magic[8];             // SNAPSHOT_MAGIC
+    uint32_t version;          // SNAPSHOT_VERSION
+    uint32_t byteOrder;        // SNAPSHOT_BYTE_ORDER
+    uint64_t reservationCount; // Number of ReservationRecords
+    uint64_t passengerCount;   // Number of PassengerRecords
+    uint64_t stringBytes;      // Size of the string pool
+    uint64_t reservationOffset; // Segment offset of the first ReservationRecord
+    uint64_t passengerOffset;  // Segment offset of the first PassengerRecord
+    uint64_t stringOffset;     // Segment offset of the string pool
+    uint64_t walSequence;      // Last booking-log sequence number included up to this segment
+    uint64_t segmentBytes;     // Size of this segment including padding
+    uint32_t segmentKind;      // SegmentKind
+    uint32_t headerCrc;        // CRC32C of this header with headerCrc set to 0
+};
+
+struct ReservationRecord {
+    uint64_t referenceKey;     // RefKey::value of the reference number
+    StringRef destination;
+    StringRef departureTime;
+    StringRef flightDate;
+    double totalPrice;
+    double discountApplied;
+    int32_t numAdults;
+    int32_t numKids;
+    uint32_t firstPassenger;   // Index of this reservation's first PassengerRecord
+    uint32_t passengerCount;   // Number of consecutive PassengerRecords owned by it
+    uint64_t slot;             // Position of the reservation in the reservation list
+    uint32_t stringSpan;       // Bytes of the string pool used by this reservation, starting at destination.offset
+    uint32_t crc;              // CRC32C of this record (crc = 0), its PassengerRecords and its string span
+};
+
+struct PassengerRecord {
+    StringRef name;
+    StringRef travelClass;
+    int32_t age;
+    int32_t seatNumber;
+};
+
+// The layouts above are the file format, so they must not change silently
+static_assert(sizeof(SnapshotHeader) == 88, "SnapshotHeader layout changed");
+static_assert(sizeof(ReservationRecord) == 80, "ReservationRecord layout changed");
+static_assert(sizeof(PassengerRecord) == 24, "PassengerRecord layout changed");
+
+// Rounds a byte count up to the next 8-byte boundary
+uint64_t alignTo8(uint64_t value) {
+    return (value + 7) & ~static_cast<uint64_t>(7);
+}
+
+// Checksum of a segment header (computed with headerCrc = 0)
+uint32_t snapshotHeaderCrc(const SnapshotHeader& header) {
+    SnapshotHeader copy = header;
+    copy.headerCrc = 0;
+    return crc32c(&copy, sizeof(copy));
+}
+
+/**
+ * @brief Checksum of a reservation record together with everything it owns.
+ * @param rec The record (its crc field is treated as 0).
+ * @param passengers The record's PassengerRecords.
+ * @param strings Start of the record's string span.
+ */
+uint32_t reservationRecordCrc(const ReservationRecord& rec, const PassengerRecord* passengers, const char* strings) {
+    ReservationRecord copy = rec;
+    copy.crc = 0;
+    uint32_t crc = crc32c(&copy, sizeof(copy));
+    crc = crc32c(passengers, rec.passengerCount * sizeof(PassengerRecord), crc);
+    return crc32c(strings, rec.stringSpan, crc);
+}
+
+// Shared by all lists: decoding is rare and short, so one lock is enough
+mutex passengerDecodeMutex;
+
+void PassengerList::decode() const {
+    if (isDecoded()) return;
+    lock_guard<mutex> lock(passengerDecodeMutex);
+    if (decoded.load(memory_order_relaxed)) return;
+    auto text = [this](const StringRef& ref) {
+        if (static_cast<uint64_t>(ref.offset) + ref.length > lazyStringBytes) return string();
+        return string(lazyStrings + ref.offset, ref.length);
+    };
+    items.reserve(lazyCount);
+    for (size_t p = 0; p < lazyCount; ++p) {
+        const PassengerRecord& pr = lazyRecords[p];
+        items.emplace_back(text(pr.name), pr.age, pr.seatNumber, text(pr.travelClass));
+    }
+    decoded.store(true, memory_order_release);
+}
+
+string_view PassengerList::nameAt(size_t i) const {
+    if (isDecoded()) return items[i].name;
+    const StringRef& ref = lazyRecords[i].name;
+    if (static_cast<uint64_t>(ref.offset) + ref.length > lazyStringBytes) return string_view();
+    return string_view(lazyStrings + ref.offset, ref.length);
+}
+
+string_view PassengerList::travelClassAt(size_t i) const {
+    if (isDecoded()) return items[i].travelClass;
+    const StringRef& ref = lazyRecords[i].travelClass;
+    if (static_cast<uint64_t>(ref.offset) + ref.length > lazyStringBytes) return string_view();
+    return string_view(lazyStrings + ref.offset, ref.length);
+}
+
+int PassengerList::ageAt(size_t i) const { return isDecoded() ? items[i].age : lazyRecords[i].age; }
+
+int PassengerList::seatAt(size_t i) const { return isDecoded() ? items[i].seatNumber : lazyRecords[i].seatNumber; }
+
+/**
+ * @brief One segment of a memory-mapped snapshot.
+ */
+struct SnapshotSegment {
+    const SnapshotHeader* header = nullptr;
+    const ReservationRecord* reservations = nullptr;
+    const PassengerRecord* passengers = nullptr;
+    const char* strings = nullptr;
+    uint64_t fileOffset = 0; // Where the segment starts in the snapshot file
+
+    size_t reservationCount() const { return static_cast<size_t>(header->reservationCount); }
+
+    // True if the i-th record lies inside the segment and matches its checksum
+    bool verify(size_t i) const {
+        const ReservationRecord& rec = reservations[i];
+        if (static_cast<uint64_t>(rec.firstPassenger) + rec.passengerCount > header->passengerCount ||
+            static_cast<uint64_t>(rec.destination.offset) + rec.stringSpan > header->stringBytes) {
+            return false;
+        }
+        return reservationRecordCrc(rec, passengers + rec.firstPassenger, strings + rec.destination.offset) == rec.crc;
+    }
+
+    // Returns the text behind a StringRef (empty if the reference points outside the pool)
+    string_view text(const StringRef& ref) const {
+        if (static_cast<uint64_t>(ref.offset) + ref.length > header->stringBytes) return string_view();
+        return string_view(strings + ref.offset, ref.length);
+    }
+
+    /**
+     * @brief Builds an owned Reservation from the i-th record.
+     * @param i The record.
+     * @param mapping If given, the passengers are left in the mapping (kept alive by this
+     * pointer) and decoded on first access; otherwise they are decoded now.
+     */
+    Reservation materialize(size_t i, const shared_ptr<const MappedFile>& mapping = nullptr) const {
+        const ReservationRecord& rec = reservations[i];
+        Reservation res;
+        res.referenceNumber = RefKey(rec.referenceKey);
+        res.destination = string(text(rec.destination));
+        res.departureTime = string(text(rec.departureTime));
+        res.flightDate = string(text(rec.flightDate));
+        res.totalPrice = rec.totalPrice;
+        res.discountApplied = rec.discountApplied;
+        res.numAdults = rec.numAdults;
+        res.numKids = rec.numKids;
+        if (static_cast<uint64_t>(rec.firstPassenger) + rec.passengerCount <= header->passengerCount) {
+            res.passengers.attach(mapping, passengers + rec.firstPassenger, rec.passengerCount, strings, header->stringBytes);
+            if (!mapping) res.passengers.begin(); // Decode now
+        }
+        return res;
+    }
+};
+
+// Checks that count elements of the given size starting at offset lie inside a segment
+bool sectionFits(uint64_t offset, uint64_t count, uint64_t elementSize, uint64_t segmentBytes) {
+    if (offset > segmentBytes) return false;
+    return count <= (segmentBytes - offset) / elementSize;
+}
+
+/**
+ * @brief Validates the snapshot segment starting at an offset of a mapped file.
+ * @param file The mapped snapshot.
+ * @param offset File offset of the segment header.
+ * @param segment Receives pointers into the mapping.
+ * @param error Receives a description of the problem on failure.
+ * @return False if the segment is damaged or incomplete.
+ */
+bool mapSnapshotSegment(const MappedFile& file, uint64_t offset, SnapshotSegment& segment, string& error) {
+    if (offset > file.size() || file.size() - offset < sizeof(SnapshotHeader)) {
+        error = "snapshot is truncated";
+        return false;
+    }
+    uint64_t available = file.size() - offset;
+    const char* base = file.data() + offset;
+    const SnapshotHeader* header = reinterpret_cast<const SnapshotHeader*>(base);
+    if (memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+        error = "not a binary snapshot";
+        return false;
+    }
+    if (header->byteOrder != SNAPSHOT_BYTE_ORDER) {
+        error = "snapshot was written on a host with a different byte order";
+        return false;
+    }
+    if (header->version != SNAPSHOT_VERSION) {
+        error = "unsupported snapshot version " + to_string(header->version);
+        return false;
+    }
+    if (snapshotHeaderCrc(*header) != header->headerCrc) {
+        error = "snapshot header is damaged";
+        return false;
+    }
+    if (header->segmentBytes < sizeof(SnapshotHeader) || header->segmentBytes > available ||
+        (offset == 0) != (header->segmentKind == SEGMENT_FULL) ||
+        !sectionFits(header->reservationOffset, header->reservationCount, sizeof(ReservationRecord), header->segmentBytes) ||
+        !sectionFits(header->passengerOffset, header->passengerCount, sizeof(PassengerRecord), header->segmentBytes) ||
+        !sectionFits(header->stringOffset, header->stringBytes, 1, header->segmentBytes)) {
+        error = "snapshot is truncated";
+        return false;
+    }
+    segment.header = header;
+    segment.fileOffset = offset;
+    segment.reservations = reinterpret_cast<const ReservationRecord*>(base + header->reservationOffset);
+    segment.passengers = reinterpret_cast<const PassengerRecord*>(base + header->passengerOffset);
+    segment.strings = base + header->stringOffset;
+    return true;
+}
+
+/**
+ * @brief Read-only view over a memory-mapped binary snapshot.
+ * Records are accessed directly from the mapping; nothing is parsed field by field.
+ */
+class SnapshotView {
+public:
+    /**
+     * @brief Maps a snapshot file and validates its segment headers.
+     * A segment cut short at the end of the file (a crash during an incremental save) is ignored;
+     * validBytes() then reports where the intact part of the file ends.
+     * @param filename The snapshot to open.
+     * @param error Receives a description of the problem if the file is not a usable snapshot.
+     * @return True if the snapshot can be used.
+     */
+    bool open(const string& filename, string& error) {
+        segments.clear();
+        intactBytes = 0;
+        file = make_shared<MappedFile>(); // Reservations decoded lazily may still use the old mapping
+        if (!file->open(filename)) {
+            error = "could not open " + filename;
+            return false;
+        }
+        uint64_t offset = 0;
+        while (offset < file->size()) {
+            SnapshotSegment segment;
+            if (!mapSnapshotSegment(*file, offset, segment, error)) {
+                if (segments.empty()) return false; // The full image itself is unusable
+                cerr << "Warning: Ignoring incomplete segment at the end of " << filename << ".\n";
+                break;
+            }
+            segments.push_back(segment);
+            offset += segment.header->segmentBytes;
+        }
+        if (segments.empty()) {
+            error = "file is too small to be a snapshot";
+            return false;
+        }
+        intactBytes = offset;
+        return true;
+    }
+
+    void close() {
+        segments.clear();
+        intactBytes = 0;
+        file = make_shared<MappedFile>();
+    }
+
+    const vector<SnapshotSegment>& getSegments() const { return segments; }
+    uint64_t walSequence() const { return segments.empty() ? 0 : segments.back().header->walSequence; }
+    uint64_t validBytes() const { return intactBytes; }
+    // The mapping, for reservations that decode their passengers lazily
+    shared_ptr<const MappedFile> mapping() const { return file; }
+
+private:
+    shared_ptr<MappedFile> file = make_shared<MappedFile>();
+    vector<SnapshotSegment> segments;
+    uint64_t intactBytes = 0;
+};
+
+/**
+ * @brief Encodes reservations as one snapshot segment.
+ * @param reservations The reservations to encode.
+ * @param slots The slot of each reservation, or nullptr for a full image (slot = position).
+ * @param kind SEGMENT_FULL or SEGMENT_DELTA.
+ * @param walSequence The last booking-log sequence number contained up to this segment.
+ * @param out Receives the encoded segment.
+ * @return False if the segment would be too large for the format.
+ */
+bool buildSnapshotSegment(const vector<Reservation>& reservations, const vector<uint64_t>* slots, SegmentKind kind,
+                          uint64_t walSequence, string& out) {
+    vector<ReservationRecord> resRecords;
+    vector<PassengerRecord> paxRecords;
+    string pool;
+    resRecords.reserve(reservations.size());
+
+    // Appends a string to the pool and returns where it lives
+    auto addString = [&pool](const string& str) {
+        StringRef ref;
+        ref.offset = static_cast<uint32_t>(pool.size());
+        ref.length = static_cast<uint32_t>(str.size());
+        pool += str;
+        return ref;
+    };
+
+    for (size_t i = 0; i < reservations.size(); ++i) {
+        const Reservation& res = reservations[i];
+        size_t stringStart = pool.size();
+        ReservationRecord rec;
+        rec.referenceKey = res.referenceNumber.value;
+        rec.destination = addString(res.destination);
+        rec.departureTime = addString(res.departureTime);
+        rec.flightDate = addString(res.flightDate);
+        rec.totalPrice = res.totalPrice;
+        rec.discountApplied = res.discountApplied;
+        rec.numAdults = res.numAdults;
+        rec.numKids = res.numKids;
+        rec.firstPassenger = static_cast<uint32_t>(paxRecords.size());
+        rec.passengerCount = static_cast<uint32_t>(res.passengers.size());
+        rec.slot = slots ? (*slots)[i] : i;
+        for (const auto& p : res.passengers) {
+            PassengerRecord pr;
+            pr.name = addString(p.name);
+            pr.travelClass = addString(p.travelClass);
+            pr.age = p.age;
+            pr.seatNumber = p.seatNumber;
+            paxRecords.push_back(pr);
+        }
+        rec.stringSpan = static_cast<uint32_t>(pool.size() - stringStart);
+        rec.crc = 0;
+        rec.crc = reservationRecordCrc(rec, paxRecords.data() + rec.firstPassenger, pool.data() + stringStart);
+        resRecords.push_back(rec);
+    }
+    if (pool.size() > numeric_limits<uint32_t>::max()) {
+        cerr << "Error: Too much text to fit in a snapshot.\n";
+        return false;
+    }
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.version = SNAPSHOT_VERSION;
+    header.byteOrder = SNAPSHOT_BYTE_ORDER;
+    header.reservationCount = resRecords.size();
+    header.passengerCount = paxRecords.size();
+    header.stringBytes = pool.size();
+    header.reservationOffset = sizeof(SnapshotHeader);
+    header.passengerOffset = header.reservationOffset + resRecords.size() * sizeof(ReservationRecord);
+    header.stringOffset = header.passengerOffset + paxRecords.size() * sizeof(PassengerRecord);
+    header.walSequence = walSequence;
+    header.segmentBytes = alignTo8(header.stringOffset + pool.size());
+    header.segmentKind = kind;
+    header.headerCrc = snapshotHeaderCrc(header);
+
+    out.clear();
+    out.reserve(header.segmentBytes);
+    out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.append(reinterpret_cast<const char*>(resRecords.data()), resRecords.size() * sizeof(ReservationRecord));
+    out.append(reinterpret_cast<const char*>(paxRecords.data()), paxRecords.size() * sizeof(PassengerRecord));
+    out += pool;
+    out.resize(header.segmentBytes, '\0');
+    return true;
+}
+
+/**
+ * @brief Writes reservations as a binary snapshot holding a single full segment.
+ * The file is written and synced under a temporary name and then renamed into place.
+ * @param reservations The reservations to write.
+ * @param filename The snapshot file to (re)write.
+ * @param walSequence The last booking-log sequence number contained in reservations.
+ * @return True on success.
+ */
+bool writeSnapshot(const vector<Reservation>& reservations, const string& filename, uint64_t walSequence = 0) {
+    string segment;
+    if (!buildSnapshotSegment(reservations, nullptr, SEGMENT_FULL, walSequence, segment)) return false;
+
+    string tempFilename = filename + ".tmp";
+    FILE* outFile = fopen(tempFilename.c_str(), "wb");
+    if (outFile == nullptr) {
+        cerr << "Error: Could not open file " << tempFilename << " for writing.\n";
+        return false;
+    }
+    bool ok = fwrite(segment.data(), 1, segment.size(), outFile) == segment.size() && syncFile(outFile);
+    fclose(outFile);
+    if (!ok) {
+        cerr << "Error: Failed while writing " << tempFilename << ".\n";
+        return false;
+    }
+    if (!replaceFile(tempFilename, filename)) {
+        cerr << "Error: Could not replace " << filename << ".\n";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Appends a delta segment holding only changed reservations to an existing snapshot.
+ * @param changed The reservations added or changed since the last save.
+ * @param slots The slot of each changed reservation.
+ * @param filename The snapshot file.
+ * @param walSequence The last booking-log sequence number contained after this delta.
+ * @param validBytes Length of the intact snapshot; a torn segment after it is overwritten.
+ * @param segmentBytes Receives the size of the appended segment.
+ * @return True if the delta is on stable storage.
+ */
+bool appendSnapshotDelta(const vector<Reservation>& changed, const vector<uint64_t>& slots, const string& filename,
+                         uint64_t walSequence, uint64_t validBytes, uint64_t& segmentBytes) {
+    string segment;
+    if (!buildSnapshotSegment(changed, &slots, SEGMENT_DELTA, walSequence, segment)) return false;
+
+    error_code ec;
+    if (filesystem::file_size(filename, ec) != validBytes) {
+        filesystem::resize_file(filename, validBytes, ec);
+        if (ec) {
+            cerr << "Error: Could not repair " << filename << ".\n";
+            return false;
+        }
+    }
+    FILE* outFile = fopen(filename.c_str(), "ab");
+    if (outFile == nullptr) {
+        cerr << "Error: Could not open file " << filename << " for writing.\n";
+        return false;
+    }
+    bool ok = fwrite(segment.data(), 1, segment.size(), outFile) == segment.size() && syncFile(outFile);
+    fclose(outFile);
+    if (!ok) {
+        cerr << "Error: Failed while appending to " << filename << ".\n";
+        return false;
+    }
+    segmentBytes = segment.size();
+    return true;
+}
+
+/**
+ * @brief Describes the shape of a snapshot file, used to decide between delta and full saves.
+ */
+struct SnapshotInfo {
+    uint64_t walSequence = 0;   // Last booking-log sequence number contained in the snapshot
+    uint64_t validBytes = 0;    // Length of the intact part of the file
+    size_t fullRecords = 0;     // Reservations in the full segment
+    size_t deltaRecords = 0;    // Reservations in all delta segments
+    size_t deltaSegments = 0;   // Number of delta segments
+    bool damaged = false;       // A record failed its checksum; later records were not loaded
+};
+
+/**
+ * @brief Loads every reservation from a binary snapshot.
+ * The file is memory-mapped, each fixed-layout record is checked against its CRC32C and copied
+ * straight into a Reservation, and delta segments are applied in order on top of the full image.
+ * Loading stops cleanly at the first record that fails its checksum and reports how many
+ * reservations were recovered.
+ * @param filename The snapshot file.
+ * @param loadedReservations Receives the reservations (appended).
+ * @param info Receives the shape of the snapshot.
+ * @param error Receives a description of the problem on failure.
+ * @param mode Whether passengers are decoded now or on first access.
+ * @return True on success.
+ */
+bool readSnapshot(const string& filename, vector<Reservation>& loadedReservations, SnapshotInfo& info, string& error,
+                  LoadMode mode = LoadMode::Full) {
+    SnapshotView view;
+    if (!view.open(filename, error)) return false;
+    info = SnapshotInfo();
+    info.walSequence = view.walSequence();
+    info.validBytes = view.validBytes();
+
+    size_t base = loadedReservations.size();
+    size_t recovered = 0;
+    shared_ptr<const MappedFile> mapping = (mode == LoadMode::HeadersOnly) ? view.mapping() : nullptr;
+    loadedReservations.reserve(base + view.getSegments().front().reservationCount());
+    for (const auto& segment : view.getSegments()) {
+        if (segment.header->segmentKind == SEGMENT_FULL) {
+            info.fullRecords += segment.reservationCount();
+        } else {
+            info.deltaRecords += segment.reservationCount();
+            ++info.deltaSegments;
+        }
+        for (size_t i = 0; i < segment.reservationCount() && !info.damaged; ++i) {
+            if (!segment.verify(i)) {
+                info.damaged = true;
+                break;
+            }
+            ++recovered;
+            uint64_t slot = segment.reservations[i].slot;
+            if (base + slot < loadedReservations.size()) {
+                loadedReservations[base + slot] = segment.materialize(i, mapping); // Patch an earlier version
+            } else {
+                loadedReservations.push_back(segment.materialize(i, mapping));
+            }
+        }
+        if (info.damaged) break;
+    }
+    if (info.damaged) {
+        cerr << "Warning: " << filename << " contains a damaged record; recovered " << recovered
+             << " reservation records written before it.\n";
+    }
+    return true;
+}
+
+/**
+ * @brief Checks whether a file starts with the binary snapshot magic.
+ * @param filename The file to inspect.
+ * @return True for binary snapshots, false for text files or missing files.
+ */
+bool isBinarySnapshot(const string& filename) {
+    ifstream inFile(filename, ios::binary);
+    char magic[sizeof(SNAPSHOT_MAGIC)] = {};
+    inFile.read(magic, sizeof(magic));
+    return inFile.gcount() == sizeof(magic) && memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) == 0;
+}
+
+// --- Reference Index (sidecar to the snapshot) ---
+//
+// reservations.idx maps packed reference numbers to the byte offset of their ReservationRecord in
+// reservations.dat, so a single reservation can be found without loading the snapshot. The file is
+// a sequence of runs, one per snapshot segment, each a header followed by entries sorted by key.
+// A delta save appends a run; a full rewrite replaces the file with a single run. A reference
+// that appears in several runs was patched by a later segment, and the newest run wins.
+// The index is derived data: when it does not cover the snapshot exactly it is simply rebuilt.
+
+const char REF_INDEX_MAGIC[8] = { 'R', 'B', 'I', 'D', 'X', '\0', '\0', '\0' };
+const uint32_t REF_INDEX_VERSION = 1;
+
+struct RefIndexRunHeader {
+    char magic[8];          // REF_INDEX_MAGIC
+    uint32_t version;       // REF_INDEX_VERSION
+    uint32_t headerCrc;     // CRC32C of this header with headerCrc set to 0
+    uint64_t entryCount;    // Number of RefIndexEntries following the header
+    uint64_t segmentOffset; // Snapshot offset of the segment indexed by this run
+    uint64_t coveredBytes;  // Snapshot length up to the end of that segment
+    uint64_t walSequence;   // walSequence of that segment
+};
+
+struct RefIndexEntry {
+    uint64_t key;          // RefKey::value of the reference number
+    uint64_t recordOffset; // Snapshot offset of the ReservationRecord
+};
+
+static_assert(sizeof(RefIndexRunHeader) == 48, "RefIndexRunHeader layout changed");
+static_assert(sizeof(RefIndexEntry) == 16, "RefIndexEntry layout changed");
+
+// A record found through the index
+struct RefIndexHit {
+    uint64_t segmentOffset; // Snapshot offset of the segment holding the record
+    uint64_t recordOffset;  // Snapshot offset of the ReservationRecord
+};
+
+// Checksum of a run header (computed with headerCrc = 0)
+uint32_t refIndexHeaderCrc(const RefIndexRunHeader& header) {
+    RefIndexRunHeader copy = header;
+    copy.headerCrc = 0;
+    return crc32c(&copy, sizeof(copy));
+}
+
+/**
+ * @brief Encodes the index run for one snapshot segment.
+ * @param segment The mapped segment.
+ * @param out Receives the run (appended).
+ */
+void buildRefIndexRun(const SnapshotSegment& segment, string& out) {
+    vector<RefIndexEntry> entries;
+    entries.reserve(segment.reservationCount());
+    uint64_t recordBase = segment.fileOffset + segment.header->reservationOffset;
+    for (size_t i = 0; i < segment.reservationCount(); ++i) {
+        RefIndexEntry entry;
+        entry.key = segment.reservations[i].referenceKey;
+        entry.recordOffset = recordBase + i * sizeof(ReservationRecord);
+        entries.push_back(entry);
+    }
+    sort(entries.begin(), entries.end(), [](const RefIndexEntry& a, const RefIndexEntry& b) {
+        return a.key != b.key ? a.key < b.key : a.recordOffset < b.recordOffset;
+    });
+
+    RefIndexRunHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, REF_INDEX_MAGIC, sizeof(REF_INDEX_MAGIC));
+    header.version = REF_INDEX_VERSION;
+    header.entryCount = entries.size();
+    header.segmentOffset = segment.fileOffset;
+    header.coveredBytes = segment.fileOffset + segment.header->segmentBytes;
+    header.walSequence = segment.header->walSequence;
+    header.headerCrc = refIndexHeaderCrc(header);
+    out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.append(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(RefIndexEntry));
+}
+
+/**
+ * @brief Read-only view over a memory-mapped reference index.
+ * Opening touches only the run headers; the entries are binary-searched in place.
+ */
+class RefIndexView {
+public:
+    /**
+     * @brief Maps an index file and validates its run headers.
+     * @param filename The index to open.
+     * @return False if the file is missing or any run is damaged or incomplete.
+     */
+    bool open(const string& filename) {
+        runs.clear();
+        if (!file.open(filename)) return false;
+        uint64_t offset = 0;
+        while (offset < file.size()) {
+            if (file.size() - offset < sizeof(RefIndexRunHeader)) return false;
+            const RefIndexRunHeader* header = reinterpret_cast<const RefIndexRunHeader*>(file.data() + offset);
+            if (memcmp(header->magic, REF_INDEX_MAGIC, sizeof(REF_INDEX_MAGIC)) != 0 ||
+                header->version != REF_INDEX_VERSION || refIndexHeaderCrc(*header) != header->headerCrc ||
+                header->entryCount > (file.size() - offset - sizeof(RefIndexRunHeader)) / sizeof(RefIndexEntry) ||
+                header->segmentOffset != coveredBytes()) {
+                return false;
+            }
+            runs.push_back(header);
+            offset += sizeof(RefIndexRunHeader) + header->entryCount * sizeof(RefIndexEntry);
+        }
+        return !runs.empty();
+    }
+
+    // Snapshot length the index describes (0 if it is empty)
+    uint64_t coveredBytes() const { return runs.empty() ? 0 : runs.back()->coveredBytes; }
+    uint64_t walSequence() const { return runs.empty() ? 0 : runs.back()->walSequence; }
+
+    /**
+     * @brief Finds the records filed under a key.
+     * Runs are searched newest first and only the newest run holding the key is reported,
+     * since later segments supersede earlier ones.
+     * @param key The packed reference number.
+     * @return The matching records in snapshot order, empty if the key is not indexed.
+     */
+    vector<RefIndexHit> find(uint64_t key) const {
+        vector<RefIndexHit> hits;
+        for (auto run = runs.rbegin(); run != runs.rend() && hits.empty(); ++run) {
+            const RefIndexEntry* first = reinterpret_cast<const RefIndexEntry*>(*run + 1);
+            const RefIndexEntry* last = first + (*run)->entryCount;
+            const RefIndexEntry* it = lower_bound(first, last, key,
+                                                  [](const RefIndexEntry& e, uint64_t k) { return e.key < k; });
+            for (; it != last && it->key == key; ++it) hits.push_back({ (*run)->segmentOffset, it->recordOffset });
+        }
+        return hits;
+    }
+
+private:
+    MappedFile file;
+    vector<const RefIndexRunHeader*> runs;
+};
+
+/**
+ * @brief Rebuilds the reference index for every segment of a snapshot.
+ * The index is written under a temporary name and renamed into place.
+ * @param snapshotFilename The snapshot to index.
+ * @param indexFilename The index file to (re)write.
+ * @return True on success.
+ */
+bool rebuildRefIndex(const string& snapshotFilename, const string& indexFilename) {
+    SnapshotView view;
+    string error;
+    if (!view.open(snapshotFilename, error)) return false;
+    string runs;
+    for (const auto& segment : view.getSegments()) buildRefIndexRun(segment, runs);
+
+    string tempFilename = indexFilename + ".tmp";
+    FILE* outFile = fopen(tempFilename.c_str(), "wb");
+    if (outFile == nullptr) {
+        cerr << "Error: Could not open file " << tempFilename << " for writing.\n";
+        return false;
+    }
+    bool ok = fwrite(runs.data(), 1, runs.size(), outFile) == runs.size() && fflush(outFile) == 0;
+    fclose(outFile);
+    if (!ok || !replaceFile(tempFilename, indexFilename)) {
+        cerr << "Error: Could not write " << indexFilename << ".\n";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Brings the reference index up to date after a segment was added to the snapshot.
+ * A delta segment only costs a new run covering its own records; if the index does not end
+ * exactly where the new segment starts (missing, stale or damaged), it is rebuilt instead.
+ * @param snapshotFilename The snapshot.
+ * @param indexFilename The index file.
+ * @param segmentOffset Where the new segment starts in the snapshot (0 after a full rewrite).
+ * @return True if the index now covers the snapshot.
+ */
+bool updateRefIndex(const string& snapshotFilename, const string& indexFilename, uint64_t segmentOffset) {
+    if (segmentOffset == 0) return rebuildRefIndex(snapshotFilename, indexFilename);
+    uint64_t indexBytes;
+    {
+        RefIndexView index;
+        if (!index.open(indexFilename) || index.coveredBytes() != segmentOffset) {
+            return rebuildRefIndex(snapshotFilename, indexFilename);
+        }
+        error_code ec;
+        indexBytes = filesystem::file_size(indexFilename, ec);
+        if (ec) return rebuildRefIndex(snapshotFilename, indexFilename);
+    }
+
+    MappedFile snapshot;
+    SnapshotSegment segment;
+    string error, run;
+    if (!snapshot.open(snapshotFilename) || !mapSnapshotSegment(snapshot, segmentOffset, segment, error)) {
+        return rebuildRefIndex(snapshotFilename, indexFilename);
+    }
+    buildRefIndexRun(segment, run);
+    FILE* outFile = fopen(indexFilename.c_str(), "ab");
+    bool ok = outFile != nullptr && fwrite(run.data(), 1, run.size(), outFile) == run.size() && fflush(outFile) == 0;
+    if (outFile != nullptr) fclose(outFile);
+    if (!ok) {
+        // A partial run fails validation, so the next update rebuilds the file
+        error_code ec;
+        filesystem::resize_file(indexFilename, indexBytes, ec);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Checks whether the reference index describes the snapshot as it is on disk.
+ * @param snapshotFilename The snapshot.
+ * @param indexFilename The index file.
+ * @return True if the index covers exactly the bytes of the snapshot.
+ */
+bool refIndexIsCurrent(const string& snapshotFilename, const string& indexFilename) {
+    RefIndexView index;
+    error_code ec;
+    uint64_t snapshotBytes = filesystem::file_size(snapshotFilename, ec);
+    return !ec && index.open(indexFilename) && index.coveredBytes() == snapshotBytes;
+}
+
+// --- Reference Filter (sidecar to the snapshot) ---
+//
+// reservations.bloom is a Bloom filter over every reference number in the snapshot and the cold
+// archive, so a lookup for a reference that was never issued (usually a typo) is answered without
+// searching either of them. The filter is cache-blocked: all bits of a key fall in one 64-byte
+// block, so a probe costs one cache miss (or one page) however large the filter grows.
+// Like the reference index it is derived data: it records which snapshot and archive it was written
+// for (their lengths, plus the snapshot's segment headers, so a snapshot rewritten to the same length
+// is told apart) and is rebuilt at load when they no longer match.
+
+const char REF_FILTER_MAGIC[8] = { 'R', 'B', 'B', 'L', 'O', 'O', 'M', '\0' };
+const uint32_t REF_FILTER_VERSION = 2;
+const uint32_t DEFAULT_FILTER_BITS_PER_KEY = 10; // About 1% false positives
+
+struct RefFilterHeader {
+    char magic[8];          // REF_FILTER_MAGIC
+    uint32_t version;       // REF_FILTER_VERSION
+    uint32_t headerCrc;     // CRC32C of this header with headerCrc set to 0
+    uint32_t bitsPerKey;    // Sizing the filter was built with
+    uint32_t hashCount;     // Bits set per key
+    uint64_t blockCount;    // 64-byte blocks following the header
+    uint64_t keyCount;      // Keys added
+    uint64_t capacity;      // Keys the filter was sized for
+    uint64_t snapshotBytes; // Length of the snapshot the filter covers
+    uint64_t archiveBytes;  // Length of the archive the filter covers
+    uint64_t walSequence;   // Booking-log sequence of the snapshot's last segment
+    uint32_t segmentsCrc;   // CRC32C chained over the headerCrc of every snapshot segment
+    uint8_t reserved[52];   // Zero; keeps the filter blocks cache-line aligned
+};
+
+static_assert(sizeof(RefFilterHeader) == 128, "RefFilterHeader layout changed");
+
+// Identity of the persisted tiers, which a filter file must match to be trusted
+struct RefFilterCoverage {
+    uint64_t snapshotBytes = 0;
+    uint64_t archiveBytes = 0;
+    uint64_t walSequence = 0;
+    uint32_t segmentsCrc = 0;
+
+    bool operator==(const RefFilterCoverage& other) const {
+        return snapshotBytes == other.snapshotBytes && archiveBytes == other.archiveBytes &&
+               walSequence == other.walSequence && segmentsCrc == other.segmentsCrc;
+    }
+};
+
+/**
+ * @brief Identifies the snapshot and archive on disk now.
+ * Besides the file lengths, the snapshot's segment headers are read (a few bytes per segment):
+ * a full rewrite of the same length still differs in its sequence number or its header checksums,
+ * so a filter left behind by a crash before it was saved is never mistaken for a current one.
+ */
+RefFilterCoverage currentRefFilterCoverage() {
+    RefFilterCoverage coverage;
+    error_code ec;
+    coverage.archiveBytes = filesystem::file_size(ARCHIVE_FILE, ec);
+    if (ec) coverage.archiveBytes = 0; // No archive yet
+    MappedFile snapshot;
+    if (!snapshot.open(SNAPSHOT_FILE)) return coverage;
+    coverage.snapshotBytes = snapshot.size();
+    uint64_t offset = 0;
+    while (snapshot.size() - offset >= sizeof(SnapshotHeader)) {
+        SnapshotHeader header;
+        memcpy(&header, snapshot.data() + offset, sizeof(header));
+        if (memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 || header.segmentBytes == 0 ||
+            header.segmentBytes > snapshot.size() - offset) {
+            break;
+        }
+        coverage.segmentsCrc = crc32c(&header.headerCrc, sizeof(header.headerCrc), coverage.segmentsCrc);
+        coverage.walSequence = header.walSequence;
+        offset += header.segmentBytes;
+    }
+    return coverage;
+}
+
+/**
+ * @brief Cache-blocked Bloom filter over reference numbers.
+ * Answers "definitely absent" or "possibly present". It is sized for a number of keys; since a
+ * Bloom filter cannot grow in place, its owner rebuilds it larger once that many have been added.
+ */
+class RefBloomFilter {
+public:
+    static const size_t BLOCK_WORDS = 8; // 512 bits per block, one cache line
+
+    /**
+     * @brief Empties the filter and sizes it.
+     * @param expectedKeys Keys the filter should hold before it needs rebuilding.
+     * @param bitsPerKey Filter bits per key; each extra bit cuts false positives by about a third.
+     */
+    void reset(size_t expectedKeys, uint32_t bitsPerKey) {
+        bitsPerKeySetting = max<uint32_t>(bitsPerKey, 1);
+        hashes = static_cast<uint32_t>(min<long>(max<long>(lround(bitsPerKeySetting * log(2.0)), 1), 16));
+        keyCapacity = max<size_t>(expectedKeys, 1024);
+        uint64_t blocks = (static_cast<uint64_t>(keyCapacity) * bitsPerKeySetting + BLOCK_WORDS * 64 - 1) / (BLOCK_WORDS * 64);
+        words.assign(blocks * BLOCK_WORDS, 0);
+        keys = 0;
+    }
+
+    /**
+     * @brief Adds a reference number; callers only add references that are new to the filter.
+     * Every add counts towards keyCount(), even one that happens to set no new bit, so the owner
+     * rebuilds the filter on time.
+     * @return True if the key set a new bit (the filter changed).
+     */
+    bool add(RefKey key) {
+        uint64_t* block;
+        uint64_t seed;
+        locate(words.data(), blockCount(), key.value, block, seed);
+        bool changed = false;
+        uint64_t bits = seed;
+        for (uint32_t i = 0; i < hashes; ++i, bits >>= 9) {
+            if (i % 7 == 0 && i != 0) bits = mix(seed + i);
+            uint64_t mask = uint64_t(1) << (bits & 63);
+            uint64_t& word = block[(bits >> 6) & 7];
+            changed |= !(word & mask);
+            word |= mask;
+        }
+        ++keys;
+        return changed;
+    }
+
+    bool mightContain(RefKey key) const { return probe(words.data(), blockCount(), hashes, key.value); }
+
+    /**
+     * @brief Tests a key against filter bits laid out as in memory or in a filter file.
+     * @return False if the key was definitely never added.
+     */
+    static bool probe(const uint64_t* words, uint64_t blockCount, uint32_t hashCount, uint64_t key) {
+        if (blockCount == 0) return true; // Never sized; rule nothing out
+        uint64_t* block;
+        uint64_t seed;
+        locate(words, blockCount, key, block, seed);
+        uint64_t bits = seed;
+        for (uint32_t i = 0; i < hashCount; ++i, bits >>= 9) {
+            if (i % 7 == 0 && i != 0) bits = mix(seed + i);
+            if (!((block[(bits >> 6) & 7] >> (bits & 63)) & 1)) return false;
+        }
+        return true;
+    }
+
+    size_t keyCount() const { return keys; }
+    size_t capacity() const { return keyCapacity; }
+    uint32_t bitsPerKey() const { return bitsPerKeySetting; }
+    uint32_t hashCount() const { return hashes; }
+    size_t memoryBytes() const { return words.size() * sizeof(uint64_t); }
+
+    /**
+     * @brief Expected false-positive rate for a key that was never added, from the bits now set.
+     * A probe lands in a random block and finds all its bits set with probability (fill)^hashes,
+     * so this averages that over the blocks.
+     */
+    double estimatedFalsePositiveRate() const {
+        if (words.empty()) return 1.0;
+        double total = 0;
+        for (size_t b = 0; b < words.size(); b += BLOCK_WORDS) {
+            int setBits = 0;
+            for (size_t w = 0; w < BLOCK_WORDS; ++w) setBits += popcount64(words[b + w]);
+            total += pow(setBits / double(BLOCK_WORDS * 64), hashes);
+        }
+        return total / blockCount();
+    }
+
+    /**
+     * @brief Writes the filter under a temporary name and renames it into place.
+     * @param filename The filter file.
+     * @param coverage The snapshot and archive whose keys the filter holds.
+     * @return True on success.
+     */
+    bool save(const string& filename, const RefFilterCoverage& coverage) const {
+        RefFilterHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, REF_FILTER_MAGIC, sizeof(REF_FILTER_MAGIC));
+        header.version = REF_FILTER_VERSION;
+        header.bitsPerKey = bitsPerKeySetting;
+        header.hashCount = hashes;
+        header.blockCount = blockCount();
+        header.keyCount = keys;
+        header.capacity = keyCapacity;
+        header.snapshotBytes = coverage.snapshotBytes;
+        header.archiveBytes = coverage.archiveBytes;
+        header.walSequence = coverage.walSequence;
+        header.segmentsCrc = coverage.segmentsCrc;
+        header.headerCrc = crc32c(&header, sizeof(header));
+
+        string tempFilename = filename + ".tmp";
+        FILE* outFile = fopen(tempFilename.c_str(), "wb");
+        if (outFile == nullptr) {
+            cerr << "Error: Could not open file " << tempFilename << " for writing.\n";
+            return false;
+        }
+        bool ok = fwrite(&header, sizeof(header), 1, outFile) == 1 &&
+                  fwrite(words.data(), sizeof(uint64_t), words.size(), outFile) == words.size() && fflush(outFile) == 0;
+        fclose(outFile);
+        if (!ok || !replaceFile(tempFilename, filename)) {
+            cerr << "Error: Could not write " << filename << ".\n";
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Loads a filter file if it was written for the given snapshot and archive.
+     * @param filename The filter file.
+     * @param coverage The current snapshot and archive.
+     * @return False (leaving the filter unchanged) if the file is missing, damaged or stale.
+     */
+    bool load(const string& filename, const RefFilterCoverage& coverage);
+
+private:
+    uint64_t blockCount() const { return words.size() / BLOCK_WORDS; }
+
+    static uint64_t mix(uint64_t x) {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+        return x;
+    }
+
+    // Picks the key's block and the seed of its bit positions (9 bits each, 7 per 64-bit hash)
+    static void locate(const uint64_t* words, uint64_t blockCount, uint64_t key, uint64_t*& block, uint64_t& seed) {
+        uint64_t hash = mix(key);
+        block = const_cast<uint64_t*>(words) + ((hash >> 32) * blockCount >> 32) * BLOCK_WORDS;
+        seed = mix(hash);
+    }
+
+    vector<uint64_t> words;       // blockCount() blocks of BLOCK_WORDS words
+    uint32_t bitsPerKeySetting = DEFAULT_FILTER_BITS_PER_KEY;
+    uint32_t hashes = 0;
+    size_t keyCapacity = 0;
+    size_t keys = 0;
+};
+
+/**
+ * @brief Read-only view over a memory-mapped filter file.
+ * A probe touches the header and one block, so the filter can be consulted without reading it.
+ */
+class RefFilterView {
+public:
+    /**
+     * @brief Maps a filter file and validates its header.
+     * @param filename The filter file.
+     * @return False if the file is missing, damaged or truncated.
+     */
+    bool open(const string& filename) {
+        header = nullptr;
+        if (!file.open(filename) || file.size() < sizeof(RefFilterHeader)) return false;
+        const RefFilterHeader* candidate = reinterpret_cast<const RefFilterHeader*>(file.data());
+        RefFilterHeader copy = *candidate;
+        copy.headerCrc = 0;
+        if (memcmp(candidate->magic, REF_FILTER_MAGIC, sizeof(REF_FILTER_MAGIC)) != 0 ||
+            candidate->version != REF_FILTER_VERSION || crc32c(&copy, sizeof(copy)) != candidate->headerCrc ||
+            candidate->blockCount != (file.size() - sizeof(RefFilterHeader)) / (RefBloomFilter::BLOCK_WORDS * sizeof(uint64_t)) ||
+            candidate->hashCount == 0 || candidate->hashCount > 16) {
+            return false;
+        }
+        header = candidate;
+        return true;
+    }
+
+    // True if the filter holds every key of this snapshot and archive
+    bool covers(const RefFilterCoverage& coverage) const {
+        if (header == nullptr) return false;
+        RefFilterCoverage written;
+        written.snapshotBytes = header->snapshotBytes;
+        written.archiveBytes = header->archiveBytes;
+        written.walSequence = header->walSequence;
+        written.segmentsCrc = header->segmentsCrc;
+        return written == coverage;
+    }
+
+    bool mightContain(RefKey key) const {
+        return RefBloomFilter::probe(bits(), header->blockCount, header->hashCount, key.value);
+    }
+
+    const RefFilterHeader& getHeader() const { return *header; }
+    const uint64_t* bits() const { return reinterpret_cast<const uint64_t*>(header + 1); }
+
+private:
+    MappedFile file;
+    const RefFilterHeader* header = nullptr;
+};
+
+bool RefBloomFilter::load(const string& filename, const RefFilterCoverage& coverage) {
+    RefFilterView view;
+    if (!view.open(filename) || !view.covers(coverage)) return false;
+    const RefFilterHeader& header = view.getHeader();
+    words.assign(view.bits(), view.bits() + header.blockCount * BLOCK_WORDS);
+    bitsPerKeySetting = header.bitsPerKey;
+    hashes = header.hashCount;
+    keyCapacity = header.capacity;
+    keys = header.keyCount;
+    return true;
+}
+
+// --- Columnar Analytics Export ---
+//
+// The columnar file stores the reservation set column by column for analytics tools: a header,
+// a directory of columns, then each column's bytes (8-byte aligned). Numbers are stored as typed
+// arrays, repetitive text (destination, departure time, flight date, class) as dictionary codes, and passengers
+// as a child table whose passenger.reservation column holds the row of the owning reservation.
+// A scan of one or two columns reads only the header, the directory and those columns.
+
+const char COLUMN_MAGIC[8] = { 'R', 'B', 'C', 'O', 'L', '\0', '\0', '\0' };
+const uint32_t COLUMN_VERSION = 2;
+
+enum ColumnType : uint32_t {
+    COLUMN_INT32 = 0,   // One int32_t per row
+    COLUMN_UINT32 = 1,  // One uint32_t per row
+    COLUMN_FLOAT64 = 2, // One double per row
+    COLUMN_STRING = 3,  // uint64_t offsets[rows + 1] into the concatenated bytes that follow
+    COLUMN_DICT = 4,    // One uint32_t code per row, indexing the COLUMN_STRING column "<name>.dict"
+    COLUMN_UINT64 = 5   // One uint64_t per row (reference numbers as RefKey::value)
+};
+
+struct ColumnFileHeader {
+    char magic[8];             // COLUMN_MAGIC
+    uint32_t version;          // COLUMN_VERSION
+    uint32_t byteOrder;        // SNAPSHOT_BYTE_ORDER
+    uint64_t reservationCount; // Rows of the reservation table
+    uint64_t passengerCount;   // Rows of the passenger table
+    uint32_t columnCount;      // ColumnEntries following the header
+    uint32_t headerCrc;        // CRC32C of this header (headerCrc = 0) and the directory
+};
+
+struct ColumnEntry {
+    char name[32];   // NUL-padded, e.g. "reservation.total_price"
+    uint32_t type;   // ColumnType
+    uint32_t crc;    // CRC32C of the column bytes
+    uint64_t rows;   // Number of rows
+    uint64_t offset; // File offset of the column bytes
+    uint64_t bytes;  // Size of the column bytes
+};
+
+static_assert(sizeof(ColumnFileHeader) == 40, "ColumnFileHeader layout changed");
+static_assert(sizeof(ColumnEntry) == 64, "ColumnEntry layout changed");
+
+/**
+ * @brief Collects encoded columns and writes them as a columnar file.
+ */
+class ColumnarWriter {
+public:
+    // Adds a column of fixed-size values
+    template <typename T>
+    void addFixed(const string& name, ColumnType type, const vector<T>& values) {
+        add(name, type, values.size(), string(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T)));
+    }
+
+    // Adds a column of variable-length strings
+    void addStrings(const string& name, const vector<string_view>& values) {
+        vector<uint64_t> offsets;
+        offsets.reserve(values.size() + 1);
+        uint64_t total = 0;
+        offsets.push_back(0);
+        for (const auto& value : values) offsets.push_back(total += value.size());
+        string bytes(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+        bytes.reserve(bytes.size() + total);
+        for (const auto& value : values) bytes.append(value.data(), value.size());
+        add(name, COLUMN_STRING, values.size(), move(bytes));
+    }
+
+    // Adds a dictionary-encoded column and its "<name>.dict" string column
+    void addDictionary(const string& name, const vector<string_view>& values) {
+        unordered_map<string_view, uint32_t> codes;
+        vector<string_view> dictionary;
+        vector<uint32_t> encoded;
+        encoded.reserve(values.size());
+        for (const auto& value : values) {
+            auto inserted = codes.emplace(value, static_cast<uint32_t>(dictionary.size()));
+            if (inserted.second) dictionary.push_back(value);
+            encoded.push_back(inserted.first->second);
+        }
+        addFixed(name, COLUMN_DICT, encoded);
+        addStrings(name + ".dict", dictionary);
+    }
+
+    /**
+     * @brief Writes the collected columns under a temporary name and renames the file into place.
+     * @param filename The columnar file.
+     * @param reservationCount Rows of the reservation table.
+     * @param passengerCount Rows of the passenger table.
+     * @return True on success.
+     */
+    bool write(const string& filename, uint64_t reservationCount, uint64_t passengerCount) {
+        ColumnFileHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, COLUMN_MAGIC, sizeof(COLUMN_MAGIC));
+        header.version = COLUMN_VERSION;
+        header.byteOrder = SNAPSHOT_BYTE_ORDER;
+        header.reservationCount = reservationCount;
+        header.passengerCount = passengerCount;
+        header.columnCount = static_cast<uint32_t>(entries.size());
+
+        uint64_t offset = alignTo8(sizeof(header) + entries.size() * sizeof(ColumnEntry));
+        for (size_t i = 0; i < entries.size(); ++i) {
+            entries[i].offset = offset;
+            offset = alignTo8(offset + entries[i].bytes);
+        }
+        header.headerCrc = crc32c(entries.data(), entries.size() * sizeof(ColumnEntry), crc32c(&header, sizeof(header)));
+
+        string tempFilename = filename + ".tmp";
+        FILE* outFile = fopen(tempFilename.c_str(), "wb");
+        if (outFile == nullptr) {
+            cerr << "Error: Could not open file " << tempFilename << " for writing.\n";
+            return false;
+        }
+        static const char padding[8] = {};
+        bool ok = fwrite(&header, sizeof(header), 1, outFile) == 1 &&
+                  fwrite(entries.data(), sizeof(ColumnEntry), entries.size(), outFile) == entries.size();
+        uint64_t written = sizeof(header) + entries.size() * sizeof(ColumnEntry);
+        for (size_t i = 0; i < entries.size() && ok; ++i) {
+            ok = fwrite(padding, 1, entries[i].offset - written, outFile) == entries[i].offset - written &&
+                 fwrite(columns[i].data(), 1, columns[i].size(), outFile) == columns[i].size();
+            written = entries[i].offset + columns[i].size();
+        }
+        ok = ok && fflush(outFile) == 0;
+        fclose(outFile);
+        if (!ok || !replaceFile(tempFilename, filename)) {
+            cerr << "Error: Could not write " << filename << ".\n";
+            return false;
+        }
+        return true;
+    }
+
+private:
+    void add(const string& name, ColumnType type, uint64_t rows, string bytes) {
+        ColumnEntry entry;
+        memset(&entry, 0, sizeof(entry));
+        name.copy(entry.name, sizeof(entry.name) - 1);
+        entry.type = type;
+        entry.rows = rows;
+        entry.bytes = bytes.size();
+        entry.crc = crc32c(bytes.data(), bytes.size());
+        entries.push_back(entry);
+        columns.push_back(move(bytes));
+    }
+
+    vector<ColumnEntry> entries;
+    vector<string> columns;
+};
+
+/**
+ * @brief Exports reservations as a columnar analytics file.
+ * @param reservations The reservations to export.
+ * @param filename The columnar file to (re)write.
+ * @return True on success.
+ */
+bool writeColumnar(const vector<Reservation>& reservations, const string& filename) {
+    size_t rows = reservations.size();
+    vector<uint64_t> references;
+    vector<string_view> destinations, departureTimes, flightDates;
+    vector<double> prices, discounts;
+    vector<int32_t> adults, kids;
+    vector<uint32_t> passengerCounts;
+    references.reserve(rows);
+    destinations.reserve(rows);
+    departureTimes.reserve(rows);
+    flightDates.reserve(rows);
+    prices.reserve(rows);
+    discounts.reserve(rows);
+    adults.reserve(rows);
+    kids.reserve(rows);
+    passengerCounts.reserve(rows);
+
+    vector<uint32_t> owners;
+    vector<string_view> names, classes;
+    vector<int32_t> ages, seats;
+    for (size_t row = 0; row < rows; ++row) {
+        const Reservation& res = reservations[row];
+        references.push_back(res.referenceNumber.value);
+        destinations.push_back(res.destination);
+        departureTimes.push_back(res.departureTime);
+        flightDates.push_back(res.flightDate);
+        prices.push_back(res.totalPrice);
+        discounts.push_back(res.discountApplied);
+        adults.push_back(res.numAdults);
+        kids.push_back(res.numKids);
+        passengerCounts.push_back(static_cast<uint32_t>(res.passengers.size()));
+        for (const auto& p : res.passengers) {
+            owners.push_back(static_cast<uint32_t>(row));
+            names.push_back(p.name);
+            classes.push_back(p.travelClass);
+            ages.push_back(p.age);
+            seats.push_back(p.seatNumber);
+        }
+    }
+
+    ColumnarWriter writer;
+    writer.addFixed("reservation.reference", COLUMN_UINT64, references);
+    writer.addDictionary("reservation.destination", destinations);
+    writer.addDictionary("reservation.departure_time", departureTimes);
+    writer.addDictionary("reservation.flight_date", flightDates);
+    writer.addFixed("reservation.total_price", COLUMN_FLOAT64, prices);
+    writer.addFixed("reservation.discount", COLUMN_FLOAT64, discounts);
+    writer.addFixed("reservation.num_adults", COLUMN_INT32, adults);
+    writer.addFixed("reservation.num_kids", COLUMN_INT32, kids);
+    writer.addFixed("reservation.passenger_count", COLUMN_UINT32, passengerCounts);
+    writer.addFixed("passenger.reservation", COLUMN_UINT32, owners);
+    writer.addStrings("passenger.name", names);
+    writer.addFixed("passenger.age", COLUMN_INT32, ages);
+    writer.addFixed("passenger.seat", COLUMN_INT32, seats);
+    writer.addDictionary("passenger.travel_class", classes);
+    return writer.write(filename, rows, owners.size());
+}
+
+/**
+ * @brief One column of a mapped columnar file.
+ */
+struct ColumnData {
+    const ColumnEntry* entry = nullptr;
+    const char* data = nullptr;
+
+    size_t rows() const { return static_cast<size_t>(entry->rows); }
+
+    // The values of a fixed-size column
+    template <typename T>
+    const T* values() const { return reinterpret_cast<const T*>(data); }
+
+    // The i-th value of a COLUMN_STRING column
+    string_view stringAt(size_t i) const {
+        const uint64_t* offsets = reinterpret_cast<const uint64_t*>(data);
+        const char* bytes = data + (entry->rows + 1) * sizeof(uint64_t);
+        return string_view(bytes + offsets[i], offsets[i + 1] - offsets[i]);
+    }
+};
+
+/**
+ * @brief Read-only view over a memory-mapped columnar file.
+ * Opening reads only the header and the directory; column bytes are touched when a column is used.
+ */
+class ColumnarView {
+public:
+    /**
+     * @brief Maps a columnar file and validates its header and directory.
+     * @param filename The file to open.
+     * @param error Receives a description of the problem on failure.
+     * @return True if the file can be used.
+     */
+    bool open(const string& filename, string& error) {
+        if (!file.open(filename)) {
+            error = "could not open " + filename;
+            return false;
+        }
+        if (file.size() < sizeof(ColumnFileHeader)) {
+            error = "file is too small to be a columnar file";
+            return false;
+        }
+        header = reinterpret_cast<const ColumnFileHeader*>(file.data());
+        if (memcmp(header->magic, COLUMN_MAGIC, sizeof(COLUMN_MAGIC)) != 0 || header->version != COLUMN_VERSION ||
+            header->byteOrder != SNAPSHOT_BYTE_ORDER) {
+            error = "not a supported columnar file";
+            return false;
+        }
+        if (header->columnCount > (file.size() - sizeof(ColumnFileHeader)) / sizeof(ColumnEntry)) {
+            error = "columnar file is truncated";
+            return false;
+        }
+        entries = reinterpret_cast<const ColumnEntry*>(header + 1);
+        ColumnFileHeader copy = *header;
+        copy.headerCrc = 0;
+        if (crc32c(entries, header->columnCount * sizeof(ColumnEntry), crc32c(&copy, sizeof(copy))) != header->headerCrc) {
+            error = "columnar file directory is damaged";
+            return false;
+        }
+        return true;
+    }
+
+    uint64_t reservationCount() const { return header->reservationCount; }
+    uint64_t passengerCount() const { return header->passengerCount; }
+    uint64_t fileBytes() const { return file.size(); }
+
+    /**
+     * @brief Looks up a column and checks its type, size and checksum.
+     * @param name The column name.
+     * @param type The expected ColumnType.
+     * @param column Receives the column.
+     * @param error Receives a description of the problem on failure.
+     * @return True if the column can be used.
+     */
+    bool column(const string& name, ColumnType type, ColumnData& column, string& error) const {
+        for (uint32_t i = 0; i < header->columnCount; ++i) {
+            const ColumnEntry& entry = entries[i];
+            if (strncmp(entry.name, name.c_str(), sizeof(entry.name)) != 0) continue;
+            uint64_t minimumBytes = (type == COLUMN_STRING) ? (entry.rows + 1) * sizeof(uint64_t)
+                                    : (type == COLUMN_FLOAT64 || type == COLUMN_UINT64) ? entry.rows * sizeof(uint64_t)
+                                                               : entry.rows * sizeof(uint32_t);
+            if (entry.type != type || entry.offset > file.size() || entry.bytes > file.size() - entry.offset ||
+                entry.bytes < minimumBytes) {
+                error = "column " + name + " has an unexpected type or size";
+                return false;
+            }
+            if (crc32c(file.data() + entry.offset, entry.bytes) != entry.crc) {
+                error = "column " + name + " is damaged";
+                return false;
+            }
+            column.entry = &entry;
+            column.data = file.data() + entry.offset;
+            if (type == COLUMN_STRING) {
+                const uint64_t* offsets = column.values<uint64_t>();
+                if (!is_sorted(offsets, offsets + entry.rows + 1) || offsets[entry.rows] > entry.bytes - minimumBytes) {
+                    error = "column " + name + " is damaged";
+                    return false;
+                }
+            }
+            return true;
+        }
+        error = "column " + name + " not found";
+        return false;
+    }
+
+private:
+    MappedFile file;
+    const ColumnFileHeader* header = nullptr;
+    const ColumnEntry* entries = nullptr;
+};
+
+/**
+ * @brief Totals revenue per destination from a columnar file.
+ * Only the destination codes, their dictionary and the price column are read.
+ * @param filename The columnar file.
+ */
+void columnarRevenueByDestination(const string& filename) {
+    ColumnarView view;
+    ColumnData codes, dictionary, prices;
+    string error;
+    if (!view.open(filename, error) || !view.column("reservation.destination", COLUMN_DICT, codes, error) ||
+        !view.column("reservation.destination.dict", COLUMN_STRING, dictionary, error) ||
+        !view.column("reservation.total_price", COLUMN_FLOAT64, prices, error)) {
+        cout << "\nCould not read " << filename << ": " << error << "\n";
+        return;
+    }
+    if (codes.rows() != prices.rows()) {
+        cout << "\nCould not read " << filename << ": column lengths differ\n";
+        return;
+    }
+
+    auto start = chrono::high_resolution_clock::now();
+    vector<double> revenue(dictionary.rows(), 0.0);
+    vector<size_t> bookings(dictionary.rows(), 0);
+    const uint32_t* code = codes.values<uint32_t>();
+    const double* price = prices.values<double>();
+    for (size_t row = 0; row < codes.rows(); ++row) {
+        if (code[row] >= revenue.size()) continue; // Corrupt code; the CRC makes this unlikely
+        revenue[code[row]] += price[row];
+        ++bookings[code[row]];
+    }
+    chrono::duration<double> duration = chrono::high_resolution_clock::now() - start;
+
+    cout << "\n--- Revenue by Destination (" << filename << ") ---\n";
+    for (size_t d = 0; d < revenue.size(); ++d) {
+        cout << "  " << left << setw(16) << dictionary.stringAt(d) << right << setw(10) << bookings[d]
+             << " reservations   RM" << fixed << setprecision(2) << revenue[d] << "\n";
+    }
+    uint64_t touched = codes.entry->bytes + dictionary.entry->bytes + prices.entry->bytes;
+    cout << "\nScanned " << codes.rows() << " rows in " << fixed << setprecision(6) << duration.count() << " seconds, reading "
+         << touched << " of " << view.fileBytes() << " bytes.\n";
+}
+
+/**
+ * @brief Saves all reservations to a file.
+ * The binary format is the primary store; the text format is kept for import and export.
+ * @param reservations The vector of Reservation objects to save.
+ * @param filename The name of the file to save to.
+ * @param format The on-disk format to write.
+ */
+void saveReservations(const vector<Reservation>& reservations, const string& filename = SNAPSHOT_FILE,
+                      StorageFormat format = StorageFormat::Binary) {
+    if (format == StorageFormat::Binary) {
+        writeSnapshot(reservations, filename);
+        return;
+    }
+
+    ofstream outFile(filename); // Open file for writing
+
+    if (!outFile.is_open()) {
+        cerr << "Error: Could not open file " << filename << " for writing.\n";
+        return;
+    }
+
+    for (const auto& res : reservations) {
+        outFile << "REF:" << res.referenceNumber << "\n";
+        outFile << "DEST:" << res.destination << "\n";
+        outFile << "TIME:" << res.departureTime << "\n";
+        if (!res.flightDate.empty()) outFile << "DATE:" << res.flightDate << "\n";
+        outFile << "PRICE:" << fixed << setprecision(2) << res.totalPrice << "\n";
+        outFile << "DISCOUNT:" << fixed << setprecision(2) << res.discountApplied << "\n";
+        outFile << "NUM_ADULTS:" << res.numAdults << "\n";
+        outFile << "NUM_KIDS:" << res.numKids << "\n";
+        outFile << "NUM_PASSENGERS:" << res.passengers.size() << "\n";
+        for (const auto& p : res.passengers) {
+            outFile << "PASSENGER:" << p.name << "," << p.age << "," << p.seatNumber << "," << p.travelClass << "\n";
+        }
+        outFile << "END_RESERVATION\n"; // Marker for end of each reservation
+    }
+
+    outFile.close(); // Close the file
+    // cout << "Reservations saved to " << filename << endl; // For debugging
+}
+
+/**
+ * @brief A problem found while parsing the text format.
+ */
+struct TextParseError {
+    size_t line;    // 1-based line number (within the parsed block until adjusted by the caller)
+    string message; // What was wrong with the line
+};
+
+// If text starts with prefix, removes it and returns true
+bool consumePrefix(string_view& text, string_view prefix) {
+    if (text.substr(0, prefix.size()) != prefix) return false;
+    text.remove_prefix(prefix.size());
+    return true;
+}
+
+// Parses a whole field as an int; false if it is empty, out of range or has trailing characters
+bool parseIntField(string_view text, int& value) {
+    const char* last = text.data() + text.size();
+    auto result = from_chars(text.data(), last, value);
+    return result.ec == errc() && result.ptr == last;
+}
+
+// Parses a whole field as a double; false if it is empty, out of range or has trailing characters
+bool parseDoubleField(string_view text, double& value) {
+    const char* last = text.data() + text.size();
+    auto result = from_chars(text.data(), last, value);
+    return result.ec == errc() && result.ptr == last;
+}
+
+/**
+ * @brief Parses a block of the structured text format without intermediate strings.
+ * Lines are examined as string_views over the (memory-mapped) buffer and numbers are read with
+ * from_chars, so the only allocations are the owned fields of the resulting reservations.
+ * The block must start at the beginning of a line. A reservation containing a malformed line, or
+ * one cut off before its END_RESERVATION line, is skipped and reported in errors.
+ * @param begin Start of the block.
+ * @param end End of the block.
+ * @param out Receives the parsed reservations.
+ * @param errors Receives a description of each malformed line.
+ * @return True if the block contained no errors.
+ */
+bool parseTextReservations(const char* begin, const char* end, vector<Reservation>& out, vector<TextParseError>& errors) {
+    size_t errorsBefore = errors.size();
+    bool inReservation = false; // out.back() is the reservation being filled
+    bool currentBad = false;    // The reservation being filled had a malformed line
+    size_t lineNumber = 0;
+    const char* pos = begin;
+
+    auto fail = [&](const string& message) {
+        errors.push_back({ lineNumber, message });
+        currentBad = true;
+    };
+
+    while (pos < end) {
+        const char* lineEnd = static_cast<const char*>(memchr(pos, '\n', end - pos));
+        if (lineEnd == nullptr) lineEnd = end;
+        string_view line(pos, lineEnd - pos);
+        pos = (lineEnd < end) ? lineEnd + 1 : end;
+        ++lineNumber;
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1); // Files written on Windows
+        if (line.empty()) continue;
+
+        if (consumePrefix(line, "REF:")) {
+            if (inReservation) {
+                errors.push_back({ lineNumber, "reservation started before the previous one ended" });
+                out.pop_back();
+            }
+            out.emplace_back();
+            inReservation = true;
+            currentBad = false;
+            if (!RefKey::fromString(line, out.back().referenceNumber)) fail("invalid reference number '" + string(line) + "'");
+            continue;
+        }
+        if (!inReservation) {
+            errors.push_back({ lineNumber, "line is outside of a reservation" });
+            continue;
+        }
+
+        Reservation& currentRes = out.back();
+        if (consumePrefix(line, "DEST:")) {
+            currentRes.destination.assign(line.data(), line.size());
+        } else if (consumePrefix(line, "TIME:")) {
+            currentRes.departureTime.assign(line.data(), line.size());
+        } else if (consumePrefix(line, "DATE:")) {
+            currentRes.flightDate.assign(line.data(), line.size());
+        } else if (consumePrefix(line, "PRICE:")) {
+            if (!parseDoubleField(line, currentRes.totalPrice)) fail("invalid price '" + string(line) + "'");
+        } else if (consumePrefix(line, "DISCOUNT:")) {
+            if (!parseDoubleField(line, currentRes.discountApplied)) fail("invalid discount '" + string(line) + "'");
+        } else if (consumePrefix(line, "NUM_ADULTS:")) {
+            if (!parseIntField(line, currentRes.numAdults)) fail("invalid adult count '" + string(line) + "'");
+        } else if (consumePrefix(line, "NUM_KIDS:")) {
+            if (!parseIntField(line, currentRes.numKids)) fail("invalid kid count '" + string(line) + "'");
+        } else if (consumePrefix(line, "NUM_PASSENGERS:")) {
+            // Not strictly needed for loading, as passenger data is read directly below
+        } else if (consumePrefix(line, "PASSENGER:")) {
+            // name,age,seat,travel class
+            size_t pos1 = line.find(',');
+            size_t pos2 = (pos1 == string_view::npos) ? pos1 : line.find(',', pos1 + 1);
+            size_t pos3 = (pos2 == string_view::npos) ? pos2 : line.find(',', pos2 + 1);
+            int age, seat;
+            if (pos3 == string_view::npos) {
+                fail("passenger needs 4 comma-separated fields (name,age,seat,class)");
+            } else if (!parseIntField(line.substr(pos1 + 1, pos2 - pos1 - 1), age)) {
+                fail("invalid passenger age '" + string(line.substr(pos1 + 1, pos2 - pos1 - 1)) + "'");
+            } else if (!parseIntField(line.substr(pos2 + 1, pos3 - pos2 - 1), seat)) {
+                fail("invalid passenger seat '" + string(line.substr(pos2 + 1, pos3 - pos2 - 1)) + "'");
+            } else {
+                currentRes.passengers.emplace_back(string(line.substr(0, pos1)), age, seat, string(line.substr(pos3 + 1)));
+            }
+        } else if (line == "END_RESERVATION") {
+            if (currentBad) out.pop_back();
+            inReservation = false;
+        } else {
+            fail("unrecognised line '" + string(line) + "'");
+        }
+    }
+
+    if (inReservation) {
+        errors.push_back({ lineNumber, "reservation " + out.back().referenceNumber.toString() + " is missing END_RESERVATION" });
+        out.pop_back();
+    }
+    return errors.size() == errorsBefore;
+}
+
+/**
+ * @brief Splits a text-format buffer into roughly equal chunks that each hold whole reservations.
+ * Every cut is placed just after an END_RESERVATION line.
+ * @param begin Start of the buffer.
+ * @param end End of the buffer.
+ * @param parts The desired number of chunks.
+ * @return Chunk boundaries: chunk i spans [cuts[i], cuts[i + 1]).
+ */
+vector<const char*> splitAtReservationBoundaries(const char* begin, const char* end, size_t parts) {
+    static const string_view marker = "\nEND_RESERVATION";
+    string_view text(begin, end - begin);
+    vector<const char*> cuts;
+    cuts.push_back(begin);
+    for (size_t i = 1; i < parts; ++i) {
+        size_t target = text.size() * i / parts;
+        size_t start = max(target, static_cast<size_t>(cuts.back() - begin));
+        size_t found = text.find(marker, start == 0 ? 0 : start - 1);
+        if (found == string_view::npos) break;
+        size_t lineEnd = text.find('\n', found + marker.size());
+        const char* cut = (lineEnd == string_view::npos) ? end : begin + lineEnd + 1;
+        if (cut > cuts.back() && cut < end) cuts.push_back(cut);
+    }
+    cuts.push_back(end);
+    return cuts;
+}
+
+/**
+ * @brief Loads reservations from a text file.
+ * The file is memory-mapped, cut into chunks at END_RESERVATION boundaries and the chunks are
+ * parsed concurrently into per-thread vectors, which are then joined in file order.
+ * Malformed reservations are skipped and reported with their line numbers.
+ * @param filename The name of the file to load from.
+ * @param threadCount Number of parser threads (0 = one per hardware thread).
+ * @return A vector of loaded Reservation objects.
+ */
+vector<Reservation> loadTextReservations(const string& filename, unsigned threadCount = 0) {
+    vector<Reservation> loadedReservations;
+    MappedFile file;
+    if (!file.open(filename)) {
+        // cerr << "Warning: Could not open file " << filename << " for reading. Starting with empty data.\n"; // For debugging
+        return loadedReservations; // Return empty vector if file doesn't exist or can't be opened
+    }
+
+    const size_t minChunkBytes = 256 * 1024; // Smaller files are not worth a thread
+    if (threadCount == 0) threadCount = max(1u, thread::hardware_concurrency());
+    size_t chunkCount = min<size_t>(threadCount, max<size_t>(1, file.size() / minChunkBytes));
+    vector<const char*> cuts = splitAtReservationBoundaries(file.data(), file.data() + file.size(), chunkCount);
+    chunkCount = cuts.size() - 1;
+
+    vector<vector<Reservation>> chunkResults(chunkCount);
+    vector<vector<TextParseError>> chunkErrors(chunkCount);
+    vector<thread> workers;
+    for (size_t i = 1; i < chunkCount; ++i) {
+        workers.emplace_back([&, i]() { parseTextReservations(cuts[i], cuts[i + 1], chunkResults[i], chunkErrors[i]); });
+    }
+    parseTextReservations(cuts[0], cuts[1], chunkResults[0], chunkErrors[0]); // The calling thread takes the first chunk
+    for (auto& worker : workers) worker.join();
+
+    // Report problems with file-wide line numbers (only computed when something went wrong)
+    const size_t maxReported = 10;
+    size_t errorCount = 0;
+    for (const auto& errors : chunkErrors) errorCount += errors.size();
+    size_t reported = 0;
+    size_t lineOffset = 0;
+    for (size_t i = 0; i < chunkCount && reported < min(errorCount, maxReported); ++i) {
+        for (const auto& error : chunkErrors[i]) {
+            if (reported++ < maxReported) {
+                cerr << "Error: " << filename << ":" << lineOffset + error.line << ": " << error.message << "\n";
+            }
+        }
+        lineOffset += count(cuts[i], cuts[i + 1], '\n');
+    }
+    if (errorCount > maxReported) {
+        cerr << "Error: " << filename << ": " << errorCount - maxReported << " more problems not shown\n";
+    }
+
+    size_t total = 0;
+    for (const auto& chunk : chunkResults) total += chunk.size();
+    loadedReservations.reserve(total);
+    for (auto& chunk : chunkResults) {
+        move(chunk.begin(), chunk.end(), back_inserter(loadedReservations));
+    }
+    // cout << "Reservations loaded from " << filename << endl; // For debugging
+    return loadedReservations;
+}
+
+/**
+ * @brief Loads reservations from a file.
+ * The format is detected from the file contents: binary snapshots are memory-mapped,
+ * anything else is read as the structured text format.
+ * @param filename The name of the file to load from.
+ * @return A vector of loaded Reservation objects.
+ */
+vector<Reservation> loadReservations(const string& filename = SNAPSHOT_FILE) {
+    if (!isBinarySnapshot(filename)) {
+        return loadTextReservations(filename);
+    }
+    vector<Reservation> loadedReservations;
+    SnapshotInfo info;
+    string error;
+    if (!readSnapshot(filename, loadedReservations, info, error)) {
+        cerr << "Error: Could not load " << filename << ": " << error << "\n";
+    }
+    return loadedReservations;
+}
+
+// --- Booking Log (Write-Ahead Log) ---
+//
+// Every booking is appended to reservations.wal and synced to disk before it is shown to the user,
+// so a crash or kill loses nothing. Layout:
+//   "RBWAL\0\0\0" magic, uint32 version, uint32 reserved
+//   then repeated records: uint32 payloadLength, uint32 crc, uint64 sequence, payload (encodeReservation)
+// The crc is the CRC32C of the payload followed by the sequence number.
+// On startup the snapshot is loaded and every record with a sequence newer than the snapshot is replayed.
+
+const char WAL_MAGIC[8] = { 'R', 'B', 'W', 'A', 'L', '\0', '\0', '\0' };
+const uint32_t WAL_VERSION = 4;
+const size_t WAL_FILE_HEADER_SIZE = 16;
+const size_t WAL_RECORD_HEADER_SIZE = 16; // payloadLength + crc + sequence
+
+// Appends the raw bytes of a trivially copyable value
+template <typename T>
+void appendBytes(string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Reads a trivially copyable value, advancing pos; returns false if the buffer is too short
+template <typename T>
+bool readBytes(const char*& pos, const char* end, T& value) {
+    if (static_cast<size_t>(end - pos) < sizeof(T)) return false;
+    memcpy(&value, pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+}
+
+void appendString(string& out, const string& str) {
+    appendBytes(out, static_cast<uint32_t>(str.size()));
+    out += str;
+}
+
+bool readString(const char*& pos, const char* end, string& str) {
+    uint32_t length;
+    if (!readBytes(pos, end, length) || static_cast<size_t>(end - pos) < length) return false;
+    str.assign(pos, length);
+    pos += length;
+    return true;
+}
+
+/**
+ * @brief Serializes one reservation into the compact binary form used by the booking log.
+ * @param res The reservation to encode.
+ * @param out Receives the encoded bytes (appended).
+ */
+void encodeReservation(const Reservation& res, string& out) {
+    appendBytes(out, res.referenceNumber.value);
+    appendString(out, res.destination);
+    appendString(out, res.departureTime);
+    appendString(out, res.flightDate);
+    appendBytes(out, res.totalPrice);
+    appendBytes(out, res.discountApplied);
+    appendBytes(out, static_cast<int32_t>(res.numAdults));
+    appendBytes(out, static_cast<int32_t>(res.numKids));
+    appendBytes(out, static_cast<uint32_t>(res.passengers.size()));
+    for (const auto& p : res.passengers) {
+        appendString(out, p.name);
+        appendBytes(out, static_cast<int32_t>(p.age));
+        appendBytes(out, static_cast<int32_t>(p.seatNumber));
+        appendString(out, p.travelClass);
+    }
+}
+
+/**
+ * @brief Decodes a reservation written by encodeReservation().
+ * @param pos Start of the encoded bytes; advanced past the reservation.
+ * @param end End of the available bytes.
+ * @param res Receives the decoded reservation.
+ * @return False if the bytes are truncated or malformed.
+ */
+bool decodeReservation(const char*& pos, const char* end, Reservation& res) {
+    int32_t numAdults, numKids;
+    uint32_t passengerCount;
+    if (!readBytes(pos, end, res.referenceNumber.value) || !readString(pos, end, res.destination) ||
+        !readString(pos, end, res.departureTime) || !readString(pos, end, res.flightDate) ||
+        !readBytes(pos, end, res.totalPrice) ||
+        !readBytes(pos, end, res.discountApplied) || !readBytes(pos, end, numAdults) ||
+        !readBytes(pos, end, numKids) || !readBytes(pos, end, passengerCount)) {
+        return false;
+    }
+    res.numAdults = numAdults;
+    res.numKids = numKids;
+    res.passengers.clear();
+    for (uint32_t i = 0; i < passengerCount; ++i) {
+        Passenger p;
+        int32_t age, seat;
+        if (!readString(pos, end, p.name) || !readBytes(pos, end, age) || !readBytes(pos, end, seat) ||
+            !readString(pos, end, p.travelClass)) {
+            return false;
+        }
+        p.age = age;
+        p.seatNumber = seat;
+        res.passengers.push_back(p);
+    }
+    return true;
+}
+
+/**
+ * @brief One record of the booking log, located in a mapped buffer.
+ */
+struct LogRecord {
+    const char* start;    // First byte of the record header
+    const char* payload;  // First byte of the encoded reservation
+    uint32_t payloadLength;
+    uint32_t crc;
+    uint64_t sequence;
+
+    const char* end() const { return payload + payloadLength; }
+    bool checksumMatches() const { return crc32c(&sequence, sizeof(sequence), crc32c(payload, payloadLength)) == crc; }
+};
+
+// Reads the record starting at pos and advances past it; false if the record is incomplete
+bool readLogRecord(const char*& pos, const char* end, LogRecord& record) {
+    const char* cursor = pos;
+    record.start = pos;
+    if (!readBytes(cursor, end, record.payloadLength) || !readBytes(cursor, end, record.crc) ||
+        !readBytes(cursor, end, record.sequence) || static_cast<size_t>(end - cursor) < record.payloadLength) {
+        return false;
+    }
+    record.payload = cursor;
+    pos = record.end();
+    return true;
+}
+
+/**
+ * @brief Reads the booking log and appends every reservation newer than the snapshot.
+ * Each record is checked against its CRC32C. A record cut short or damaged by a crash ends the
+ * replay cleanly (it was never acknowledged to the user), and the number of bookings recovered
+ * is reported.
+ * @param filename The log file.
+ * @param afterSequence Records with a sequence number at or below this are already in the snapshot.
+ * @param reservations Receives the replayed reservations (appended).
+ * @param validBytes Receives the length of the log up to the end of the last complete record.
+ * @return The highest sequence number seen (afterSequence if the log is empty or missing).
+ */
+uint64_t replayBookingLog(const string& filename, uint64_t afterSequence, vector<Reservation>& reservations, uint64_t& validBytes) {
+    validBytes = 0;
+    MappedFile file;
+    if (!file.open(filename) || file.size() < WAL_FILE_HEADER_SIZE ||
+        memcmp(file.data(), WAL_MAGIC, sizeof(WAL_MAGIC)) != 0) {
+        return afterSequence;
+    }
+    uint32_t version;
+    memcpy(&version, file.data() + sizeof(WAL_MAGIC), sizeof(version));
+    if (version != WAL_VERSION) {
+        cerr << "Error: Unsupported booking log version " << version << " in " << filename << ".\n";
+        return afterSequence;
+    }
+
+    uint64_t lastSequence = afterSequence;
+    const char* pos = file.data() + WAL_FILE_HEADER_SIZE;
+    const char* end = file.data() + file.size();
+    validBytes = WAL_FILE_HEADER_SIZE;
+    size_t recovered = 0;
+    while (pos < end) {
+        LogRecord record;
+        Reservation res;
+        if (!readLogRecord(pos, end, record) || !record.checksumMatches()) {
+            cerr << "Warning: " << filename << " ends with a torn or damaged record; recovered "
+                 << recovered << " bookings written before it.\n";
+            break;
+        }
+        const char* payload = record.payload;
+        if (!decodeReservation(payload, record.end(), res)) {
+            cerr << "Warning: " << filename << " contains a malformed record; recovered "
+                 << recovered << " bookings written before it.\n";
+            break;
+        }
+        ++recovered;
+        validBytes = static_cast<uint64_t>(pos - file.data());
+        if (record.sequence > afterSequence) {
+            reservations.push_back(res);
+        }
+        lastSequence = max(lastSequence, record.sequence);
+    }
+    return lastSequence;
+}
+
+/**
+ * @brief Tuning knobs for group commit in the booking log.
+ * A booking waits at most `window` for others to join its batch; a batch is also
+ * committed as soon as it holds maxBatchRecords bookings.
+ */
+struct GroupCommitSettings {
+    chrono::microseconds window{ 2000 }; // Durability window (0 = commit whatever is queued immediately)
+    size_t maxBatchRecords = 64;         // Commit early once this many bookings are waiting
+};
+
+/**
+ * @brief Counters describing how well group commit is batching.
+ */
+struct GroupCommitStats {
+    uint64_t batches = 0;            // Number of write+fsync rounds
+    uint64_t records = 0;            // Bookings made durable
+    uint64_t largestBatch = 0;       // Most bookings committed by a single fsync
+    double totalCommitSeconds = 0.0; // Time spent in write+fsync
+    double maxCommitSeconds = 0.0;   // Slowest single write+fsync
+    double totalWaitSeconds = 0.0;   // Time callers spent between append() and durability
+
+    double averageBatchSize() const { return batches ? static_cast<double>(records) / batches : 0.0; }
+    double averageCommitSeconds() const { return batches ? totalCommitSeconds / batches : 0.0; }
+    double averageWaitSeconds() const { return records ? totalWaitSeconds / records : 0.0; }
+};
+
+/**
+ * @brief Append-only log of bookings with group commit.
+ * Callers hand their record to a single writer thread and wait. The writer gathers every record
+ * that arrives within the durability window (or until the batch is full), writes them with one
+ * write and one fsync, and then releases all of those callers together. Each append costs the
+ * same regardless of how many reservations exist; the full snapshot is only rewritten by
+ * checkpointReservations().
+ */
+class BookingLog {
+public:
+    ~BookingLog() { close(); }
+
+    /**
+     * @brief Opens the log for appending, creating it if needed, and starts the writer thread.
+     * @param filename The log file.
+     * @param validBytes Length of the intact prefix reported by replayBookingLog(); anything after it is discarded.
+     *        If it does not even cover the header, an existing file is renamed to filename.unreadable first.
+     * @param lastSequence The highest sequence number already used.
+     * @return True if the log is ready for appends.
+     */
+    bool open(const string& filename, uint64_t validBytes, uint64_t lastSequence) {
+        close();
+        logFilename = filename;
+        nextSequence = lastSequence + 1;
+        durableSequence = lastSequence;
+        logBytes = validBytes;
+        bool opened;
+        if (validBytes < WAL_FILE_HEADER_SIZE) {
+            // A log that could not be read (e.g. an older format version) may hold bookings that were
+            // never replayed, so it is kept aside instead of being truncated
+            error_code ec;
+            uintmax_t existingBytes = filesystem::file_size(filename, ec);
+            if (!ec && existingBytes > 0) {
+                string keptFilename = filename + ".unreadable";
+                for (int n = 1; filesystem::exists(keptFilename, ec); ++n) keptFilename = filename + ".unreadable." + to_string(n);
+                if (!replaceFile(filename, keptFilename)) {
+                    cerr << "Error: Could not set aside unreadable booking log " << filename << "; bookings will not be logged.\n";
+                    return false;
+                }
+                cerr << "Error: Could not read booking log " << filename << ". It has been kept as " << keptFilename << ".\n";
+            }
+            opened = recreateFile();
+        } else {
+            error_code ec;
+            if (filesystem::file_size(filename, ec) != validBytes) {
+                filesystem::resize_file(filename, validBytes, ec); // Drop a torn tail before appending after it
+            }
+            logFile = ec ? nullptr : fopen(filename.c_str(), "ab");
+            opened = logFile != nullptr;
+            if (!opened) cerr << "Error: Could not open booking log " << filename << " for writing.\n";
+        }
+        if (opened) {
+            stopping = false;
+            writer = thread(&BookingLog::writerLoop, this);
+        }
+        return opened;
+    }
+
+    /**
+     * @brief Appends a booking and waits until the batch containing it is on stable storage.
+     * Safe to call from several threads at once.
+     * @param res The new reservation.
+     * @return The booking's log sequence number once it is durable, or 0 if it could not be logged.
+     */
+    uint64_t append(const Reservation& res) {
+        string record;
+        record.resize(WAL_RECORD_HEADER_SIZE);
+        encodeReservation(res, record);
+        uint32_t payloadLength = static_cast<uint32_t>(record.size() - WAL_RECORD_HEADER_SIZE);
+        uint32_t payloadCrc = crc32c(record.data() + WAL_RECORD_HEADER_SIZE, payloadLength);
+        memcpy(&record[0], &payloadLength, sizeof(payloadLength));
+
+        auto start = chrono::steady_clock::now();
+        unique_lock<mutex> lock(queueMutex);
+        if (logFile == nullptr || broken) return 0;
+        uint64_t sequence = nextSequence++;
+        uint32_t crc = crc32c(&sequence, sizeof(sequence), payloadCrc);
+        memcpy(&record[sizeof(payloadLength)], &crc, sizeof(crc));
+        memcpy(&record[sizeof(payloadLength) + sizeof(crc)], &sequence, sizeof(sequence));
+        pending += record;
+        ++pendingRecords;
+        if (pendingRecords == 1) firstPendingAt = start;
+        workAvailable.notify_one();
+
+        batchDurable.wait(lock, [&] { return durableSequence >= sequence || broken; });
+        stats.totalWaitSeconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        if (durableSequence < sequence) {
+            cerr << "Error: Could not write booking to " << logFilename << ".\n";
+            return 0;
+        }
+        return sequence;
+    }
+
+    /**
+     * @brief Drops every record already contained in a snapshot.
+     * Records newer than the snapshot (bookings made while it was being written) are copied into a
+     * fresh log that replaces the old one; records still queued are committed to the new file.
+     * @param throughSequence The last sequence number contained in the snapshot.
+     * @return True if the log was compacted.
+     */
+    bool compact(uint64_t throughSequence) {
+        unique_lock<mutex> lock(queueMutex);
+        batchDurable.wait(lock, [&] { return !writing; }); // The writer only starts new I/O while holding the lock
+
+        string tail; // Durable records newer than the snapshot
+        if (durableSequence > throughSequence) {
+            MappedFile current;
+            if (!current.open(logFilename)) return false;
+            const char* pos = current.data() + min(current.size(), WAL_FILE_HEADER_SIZE);
+            const char* end = current.data() + current.size();
+            LogRecord record;
+            while (readLogRecord(pos, end, record) && record.checksumMatches()) {
+                if (record.sequence > throughSequence) tail.append(record.start, record.end());
+            }
+        }
+
+        if (logFile != nullptr) fclose(logFile);
+        logFile = nullptr;
+        uint64_t liveBytes = logBytes;
+        string liveFilename = logFilename;
+        string tempFilename = liveFilename + ".tmp";
+        logFilename = tempFilename;
+        bool ok = recreateFile() && fwrite(tail.data(), 1, tail.size(), logFile) == tail.size() && syncFile(logFile);
+        if (logFile != nullptr) fclose(logFile);
+        logFilename = liveFilename;
+        if (!ok || !replaceFile(tempFilename, logFilename)) {
+            cerr << "Error: Could not compact booking log " << logFilename << ".\n";
+            logFile = fopen(logFilename.c_str(), "ab"); // Keep appending to the old, complete log
+            logBytes = liveBytes;
+            return false;
+        }
+        logFile = fopen(logFilename.c_str(), "ab");
+        logBytes = WAL_FILE_HEADER_SIZE + tail.size();
+        broken = logFile == nullptr;
+        return !broken;
+    }
+
+    // Current size of the log file in bytes
+    uint64_t sizeBytes() {
+        lock_guard<mutex> lock(queueMutex);
+        return logBytes;
+    }
+
+    // Stops the writer thread (after committing anything queued) and closes the file
+    void close() {
+        {
+            lock_guard<mutex> lock(queueMutex);
+            stopping = true;
+        }
+        workAvailable.notify_all();
+        if (writer.joinable()) writer.join();
+        if (logFile != nullptr) fclose(logFile);
+        logFile = nullptr;
+    }
+
+    // Sequence number of the most recent append
+    uint64_t lastSequence() {
+        lock_guard<mutex> lock(queueMutex);
+        return nextSequence - 1;
+    }
+
+    GroupCommitSettings getSettings() {
+        lock_guard<mutex> lock(queueMutex);
+        return settings;
+    }
+
+    void setSettings(const GroupCommitSettings& newSettings) {
+        lock_guard<mutex> lock(queueMutex);
+        settings = newSettings;
+        if (settings.maxBatchRecords == 0) settings.maxBatchRecords = 1;
+        workAvailable.notify_all();
+    }
+
+    GroupCommitStats getStats() {
+        lock_guard<mutex> lock(queueMutex);
+        return stats;
+    }
+
+    // Replaces the counters (e.g. to measure one run) and returns the previous ones
+    GroupCommitStats exchangeStats(const GroupCommitStats& replacement = GroupCommitStats()) {
+        lock_guard<mutex> lock(queueMutex);
+        GroupCommitStats previous = stats;
+        stats = replacement;
+        return previous;
+    }
+
+private:
+    // Creates an empty log containing only the file header (queueMutex held or writer not running)
+    bool recreateFile() {
+        logFile = fopen(logFilename.c_str(), "wb");
+        if (logFile == nullptr) {
+            cerr << "Error: Could not open booking log " << logFilename << " for writing.\n";
+            return false;
+        }
+        char header[WAL_FILE_HEADER_SIZE] = {};
+        memcpy(header, WAL_MAGIC, sizeof(WAL_MAGIC));
+        memcpy(header + sizeof(WAL_MAGIC), &WAL_VERSION, sizeof(WAL_VERSION));
+        if (fwrite(header, 1, sizeof(header), logFile) != sizeof(header) || !syncFile(logFile)) {
+            cerr << "Error: Could not write booking log " << logFilename << ".\n";
+            return false;
+        }
+        logBytes = WAL_FILE_HEADER_SIZE;
+        return true;
+    }
+
+    // Single writer: batches queued records and commits each batch with one write + fsync
+    void writerLoop() {
+        unique_lock<mutex> lock(queueMutex);
+        while (true) {
+            workAvailable.wait(lock, [&] { return stopping || pendingRecords > 0; });
+            if (pendingRecords == 0) break; // Stopping with nothing left to commit
+
+            // Let more bookings join the batch until the window closes or the batch is full
+            auto deadline = firstPendingAt + settings.window;
+            workAvailable.wait_until(lock, deadline, [&] {
+                return stopping || pendingRecords >= settings.maxBatchRecords;
+            });
+
+            string batch;
+            batch.swap(pending);
+            uint64_t batchRecords = pendingRecords;
+            uint64_t batchLastSequence = nextSequence - 1;
+            pendingRecords = 0;
+            writing = true;
+            FILE* file = broken ? nullptr : logFile; // Never commit past a failed batch
+            lock.unlock();
+
+            // New bookings keep queueing while this batch is written
+            auto commitStart = chrono::steady_clock::now();
+            bool ok = file != nullptr && fwrite(batch.data(), 1, batch.size(), file) == batch.size() && syncFile(file);
+            double commitSeconds = chrono::duration<double>(chrono::steady_clock::now() - commitStart).count();
+
+            lock.lock();
+            writing = false;
+            if (ok) logBytes += batch.size();
+            if (ok) durableSequence = batchLastSequence;
+            else broken = true; // After a failed fsync the file contents can no longer be trusted
+            ++stats.batches;
+            stats.records += batchRecords;
+            stats.largestBatch = max(stats.largestBatch, batchRecords);
+            stats.totalCommitSeconds += commitSeconds;
+            stats.maxCommitSeconds = max(stats.maxCommitSeconds, commitSeconds);
+            batchDurable.notify_all();
+        }
+    }
+
+    string logFilename;
+    FILE* logFile = nullptr;
+    uint64_t nextSequence = 1;      // Sequence number for the next append
+    uint64_t durableSequence = 0;   // Every record up to this sequence is synced
+    uint64_t logBytes = 0;          // Size of the log file including its header
+    bool broken = false;            // A batch failed; no further appends are acknowledged
+
+    mutex queueMutex;                 // Guards every member below and the fields above
+    condition_variable workAvailable; // Signals the writer that records are queued
+    condition_variable batchDurable;  // Signals callers that a batch finished
+    string pending;                   // Encoded records waiting for the next batch
+    uint64_t pendingRecords = 0;
+    chrono::steady_clock::time_point firstPendingAt; // Arrival of the oldest queued record
+    bool writing = false;             // True while the writer is outside the lock doing I/O
+    bool stopping = false;
+    GroupCommitSettings settings;
+    GroupCommitStats stats;
+    thread writer;
+};
+
+BookingLog bookingLog; // Durable log of bookings made since the last snapshot
+
+// --- Streaming Access ---
+
+/**
+ * @brief Reads persisted reservations one at a time with bounded memory.
+ * A binary snapshot is walked record by record through its mapping (a record patched by a later
+ * delta segment is yielded once, in its newest version), followed by the bookings in the booking
+ * log that the snapshot does not yet contain. A text file is parsed one block at a time.
+ * Only one block of text, and the slots patched by delta segments, are ever held in memory, so
+ * the data may be far larger than RAM.
+ */
+class ReservationCursor {
+public:
+    /**
+     * @brief Opens a data file for streaming.
+     * @param filename A binary snapshot or a text file.
+     * @param logFilename The booking log to read after a snapshot, or "" for none.
+     * @param error Receives a description of the problem on failure.
+     * @return True if the data can be streamed.
+     */
+    bool open(const string& filename, const string& logFilename, string& error) {
+        close();
+        // The log is mapped first: a checkpoint running meanwhile can only move bookings from the
+        // log into a newer snapshot, never drop them from both
+        if (!logFilename.empty() && logFile.open(logFilename) && logFile.size() >= WAL_FILE_HEADER_SIZE &&
+            memcmp(logFile.data(), WAL_MAGIC, sizeof(WAL_MAGIC)) == 0) {
+            uint32_t version;
+            memcpy(&version, logFile.data() + sizeof(WAL_MAGIC), sizeof(version));
+            if (version == WAL_VERSION) logPos = logFile.data() + WAL_FILE_HEADER_SIZE;
+        }
+
+        if (isBinarySnapshot(filename)) {
+            if (!snapshot.open(filename, error)) return false;
+            walSequence = snapshot.walSequence();
+            const auto& segments = snapshot.getSegments();
+            for (size_t s = 1; s < segments.size(); ++s) {
+                for (size_t i = 0; i < segments[s].reservationCount(); ++i) latestSegment[segments[s].reservations[i].slot] = s;
+            }
+            return true;
+        }
+        if (!textFile.open(filename)) {
+            error = "could not open " + filename;
+            return false;
+        }
+        textPos = textFile.data();
+        isText = true;
+        return true;
+    }
+
+    /**
+     * @brief Yields the next reservation.
+     * @param res Receives the reservation.
+     * @return False once the data is exhausted.
+     */
+    bool next(Reservation& res) {
+        if (isText) {
+            if (nextFromText(res)) return true;
+        } else if (nextFromSnapshot(res)) {
+            return true;
+        }
+        return nextFromLog(res);
+    }
+
+    // Records skipped because they failed their checksum or could not be parsed
+    size_t damagedRecords() const { return damaged; }
+
+    void close() {
+        snapshot.close();
+        textFile.close();
+        logFile.close();
+        latestSegment.clear();
+        textBlock.clear();
+        segmentIndex = recordIndex = textBlockPos = damaged = 0;
+        walSequence = 0;
+        textPos = logPos = nullptr;
+        isText = false;
+    }
+
+private:
+    bool nextFromSnapshot(Reservation& res) {
+        const auto& segments = snapshot.getSegments();
+        while (segmentIndex < segments.size()) {
+            const SnapshotSegment& segment = segments[segmentIndex];
+            if (recordIndex >= segment.reservationCount()) {
+                ++segmentIndex;
+                recordIndex = 0;
+                continue;
+            }
+            size_t i = recordIndex++;
+            auto latest = latestSegment.find(segment.reservations[i].slot);
+            if (latest != latestSegment.end() && latest->second != segmentIndex) continue; // Superseded
+            if (!segment.verify(i)) {
+                ++damaged;
+                continue;
+            }
+            res = segment.materialize(i, snapshot.mapping()); // Passengers stay in the mapping until read
+            return true;
+        }
+        return false;
+    }
+
+    bool nextFromText(Reservation& res) {
+        static const string_view marker = "\nEND_RESERVATION";
+        const size_t blockBytes = 64 * 1024;
+        const char* end = textFile.data() + textFile.size();
+        while (textBlockPos >= textBlock.size()) {
+            if (textPos == nullptr || textPos >= end) return false;
+            // Cut the next block just after an END_RESERVATION line
+            string_view rest(textPos, end - textPos);
+            size_t found = rest.find(marker, min(blockBytes, rest.size()));
+            size_t lineEnd = (found == string_view::npos) ? string_view::npos : rest.find('\n', found + marker.size());
+            const char* blockEnd = (lineEnd == string_view::npos) ? end : textPos + lineEnd + 1;
+            textBlock.clear();
+            textBlockPos = 0;
+            vector<TextParseError> errors;
+            parseTextReservations(textPos, blockEnd, textBlock, errors);
+            damaged += errors.size();
+            textPos = blockEnd;
+        }
+        res = move(textBlock[textBlockPos++]);
+        return true;
+    }
+
+    bool nextFromLog(Reservation& res) {
+        if (logPos == nullptr) return false;
+        const char* end = logFile.data() + logFile.size();
+        while (logPos < end) {
+            LogRecord record;
+            if (!readLogRecord(logPos, end, record) || !record.checksumMatches()) break; // Torn tail
+            const char* payload = record.payload;
+            Reservation decoded;
+            if (!decodeReservation(payload, record.end(), decoded)) break;
+            if (record.sequence <= walSequence) continue; // Already in the snapshot
+            res = move(decoded);
+            return true;
+        }
+        logPos = nullptr;
+        return false;
+    }
+
+    SnapshotView snapshot;
+    unordered_map<uint64_t, size_t> latestSegment; // Slot -> last delta segment holding it
+    size_t segmentIndex = 0;
+    size_t recordIndex = 0;
+    uint64_t walSequence = 0;
+
+    bool isText = false;
+    MappedFile textFile;
+    const char* textPos = nullptr;
+    vector<Reservation> textBlock; // Parsed reservations of the current text block
+    size_t textBlockPos = 0;
+
+    MappedFile logFile;
+    const char* logPos = nullptr;
+    size_t damaged = 0;
+};
+
+// --- Cold Archive ---
+//
+// Reservations for flights that have already departed never change again, so they are moved out of
+// allReservations into reservations.arc, an append-only file of compressed blocks. Each block holds
+// up to ARCHIVE_BLOCK_BYTES of reservations (encoded as in the booking log, sorted by reference
+// number) compressed with a small LZ77 coder, behind a header giving the smallest and largest
+// reference key in the block. A lookup only decompresses blocks whose key range contains the key.
+
+const char ARCHIVE_MAGIC[8] = { 'R', 'B', 'A', 'R', 'C', 'H', '\0', '\0' };
+const uint32_t ARCHIVE_VERSION = 2;
+const size_t ARCHIVE_BLOCK_BYTES = 64 * 1024; // Uncompressed bytes per block
+
+struct ArchiveBlockHeader {
+    char magic[8];            // ARCHIVE_MAGIC
+    uint32_t version;         // ARCHIVE_VERSION
+    uint32_t reservationCount; // Reservations in the block
+    uint64_t minKey;          // Smallest RefKey::value in the block
+    uint64_t maxKey;          // Largest RefKey::value in the block
+    uint32_t rawBytes;        // Size of the encoded reservations
+    uint32_t compressedBytes; // Size of the compressed payload following the header
+    uint32_t payloadCrc;      // CRC32C of the compressed payload
+    uint32_t headerCrc;       // CRC32C of this header with headerCrc set to 0
+};
+
+static_assert(sizeof(ArchiveBlockHeader) == 48, "ArchiveBlockHeader layout changed");
+
+/**
+ * @brief Compresses a buffer with a byte-oriented LZ77 coder (LZ4-style sequences).
+ * Each sequence is a token (high nibble: literal count, low nibble: match length - 4, with 15
+ * meaning "more length bytes follow"), the literals, and a 16-bit offset to the match. The last
+ * sequence carries only literals.
+ * @param data The bytes to compress.
+ * @param size Number of bytes.
+ * @return The compressed bytes.
+ */
+string lzCompress(const char* data, size_t size) {
+    const size_t minMatch = 4;
+    const size_t maxOffset = 65535;
+    const int hashBits = 14;
+    vector<uint32_t> table(size_t(1) << hashBits, numeric_limits<uint32_t>::max());
+    string out;
+    out.reserve(size / 2 + 16);
+
+    auto appendLength = [&out](size_t length) {
+        for (; length >= 255; length -= 255) out += static_cast<char>(255);
+        out += static_cast<char>(length);
+    };
+    auto appendLiterals = [&](size_t from, size_t to, size_t matchCode) {
+        size_t literals = to - from;
+        out += static_cast<char>((min<size_t>(literals, 15) << 4) | min<size_t>(matchCode, 15));
+        if (literals >= 15) appendLength(literals - 15);
+        out.append(data + from, literals);
+    };
+
+    size_t anchor = 0;
+    size_t pos = 0;
+    while (pos + minMatch <= size) {
+        uint32_t sequence;
+        memcpy(&sequence, data + pos, sizeof(sequence));
+        uint32_t hash = (sequence * 2654435761u) >> (32 - hashBits);
+        uint32_t candidate = table[hash];
+        table[hash] = static_cast<uint32_t>(pos);
+        if (candidate == numeric_limits<uint32_t>::max() || pos - candidate > maxOffset ||
+            memcmp(data + candidate, data + pos, minMatch) != 0) {
+            ++pos;
+            continue;
+        }
+        size_t length = minMatch;
+        while (pos + length < size && data[candidate + length] == data[pos + length]) ++length;
+        appendLiterals(anchor, pos, length - minMatch);
+        size_t offset = pos - candidate;
+        out += static_cast<char>(offset & 0xFF);
+        out += static_cast<char>(offset >> 8);
+        if (length - minMatch >= 15) appendLength(length - minMatch - 15);
+        pos += length;
+        anchor = pos;
+    }
+    appendLiterals(anchor, size, 0);
+    return out;
+}
+
+/**
+ * @brief Decompresses a buffer written by lzCompress().
+ * @param data The compressed bytes.
+ * @param size Number of compressed bytes.
+ * @param rawBytes The expected decompressed size.
+ * @param out Receives the decompressed bytes.
+ * @return False if the input is malformed.
+ */
+bool lzDecompress(const char* data, size_t size, size_t rawBytes, string& out) {
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(data);
+    const unsigned char* end = in + size;
+    out.clear();
+    out.reserve(rawBytes);
+
+    auto readLength = [&in, end](size_t& length) {
+        unsigned char byte;
+        do {
+            if (in >= end) return false;
+            byte = *in++;
+            length += byte;
+        } while (byte == 255);
+        return true;
+    };
+
+    while (in < end) {
+        unsigned char token = *in++;
+        size_t literals = token >> 4;
+        if (literals == 15 && !readLength(literals)) return false;
+        if (static_cast<size_t>(end - in) < literals || rawBytes - out.size() < literals) return false;
+        out.append(reinterpret_cast<const char*>(in), literals);
+        in += literals;
+        if (in == end) break; // The last sequence has no match
+        if (end - in < 2) return false;
+        size_t offset = in[0] | (in[1] << 8);
+        in += 2;
+        size_t length = token & 15;
+        if (length == 15 && !readLength(length)) return false;
+        length += 4;
+        if (offset == 0 || offset > out.size() || rawBytes - out.size() < length) return false;
+        size_t from = out.size() - offset;
+        for (size_t i = 0; i < length; ++i) out += out[from + i]; // May overlap the bytes being written
+    }
+    return out.size() == rawBytes;
+}
+
+/**
+ * @brief The cold archive of departed flights: a mapped, append-only file of compressed blocks.
+ * Only block headers are read when the archive is opened; the min/max keys they hold form the
+ * block index.
+ */
+class ColdArchive {
+public:
+    /**
+     * @brief Maps the archive and reads its block headers.
+     * A block cut short at the end of the file (a crash while archiving) is ignored; its
+     * reservations are still in the snapshot and are archived again next time.
+     * @param filename The archive file (a missing file is an empty archive).
+     * @return False if the file exists but is not an archive.
+     */
+    bool open(const string& filename) {
+        blocks.clear();
+        totalReservations = 0;
+        intactBytes = 0;
+        file.close();
+        if (!file.open(filename)) return true;
+        uint64_t offset = 0;
+        while (offset < file.size()) {
+            if (file.size() - offset < sizeof(ArchiveBlockHeader)) break;
+            const ArchiveBlockHeader* header = reinterpret_cast<const ArchiveBlockHeader*>(file.data() + offset);
+            ArchiveBlockHeader copy = *header;
+            copy.headerCrc = 0;
+            if (memcmp(header->magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) != 0 || header->version != ARCHIVE_VERSION ||
+                crc32c(&copy, sizeof(copy)) != header->headerCrc) {
+                if (offset == 0) {
+                    cerr << "Error: " << filename << " is not a reservation archive.\n";
+                    return false;
+                }
+                break;
+            }
+            if (file.size() - offset - sizeof(ArchiveBlockHeader) < header->compressedBytes) break;
+            blocks.push_back(header);
+            totalReservations += header->reservationCount;
+            offset += sizeof(ArchiveBlockHeader) + header->compressedBytes;
+        }
+        if (offset < file.size()) {
+            cerr << "Warning: Ignoring incomplete block at the end of " << filename << ".\n";
+        }
+        intactBytes = offset;
+        return true;
+    }
+
+    size_t reservationCount() const { return totalReservations; }
+    size_t blockCount() const { return blocks.size(); }
+    uint64_t validBytes() const { return intactBytes; }
+
+    /**
+     * @brief Finds an archived reservation by reference number.
+     * @param refNum The reference number.
+     * @param found Receives the reservation.
+     * @return True if it is in the archive.
+     */
+    bool find(RefKey refNum, Reservation& found) const {
+        for (auto block = blocks.rbegin(); block != blocks.rend(); ++block) {
+            if (refNum.value < (*block)->minKey || refNum.value > (*block)->maxKey) continue;
+            bool located = false;
+            auto match = [&](Reservation& res) {
+                if (located || res.referenceNumber != refNum) return;
+                found = move(res);
+                located = true;
+            };
+            decodeBlock(*block, match);
+            if (located) return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Calls visit for every archived reservation, one block in memory at a time.
+     * @param visit Called with each reservation.
+     * @return Number of blocks that could not be read.
+     */
+    template <typename Visitor>
+    size_t forEach(Visitor visit) const {
+        size_t damaged = 0;
+        for (const ArchiveBlockHeader* block : blocks) {
+            if (!decodeBlock(block, visit)) ++damaged;
+        }
+        return damaged;
+    }
+
+    /**
+     * @brief Appends reservations to an archive file as compressed blocks and syncs it.
+     * @param filename The archive file.
+     * @param reservations The reservations to archive (sorted here by reference number).
+     * @param validBytes Length of the intact archive; a torn block after it is overwritten.
+     * @return True if the blocks are on stable storage.
+     */
+    static bool append(const string& filename, vector<Reservation> reservations, uint64_t validBytes) {
+        sort(reservations.begin(), reservations.end(), [](const Reservation& a, const Reservation& b) {
+            return a.referenceNumber < b.referenceNumber;
+        });
+        string blocksOut;
+        string raw;
+        size_t first = 0;
+        for (size_t i = 0; i < reservations.size(); ++i) {
+            encodeReservation(reservations[i], raw);
+            if (raw.size() >= ARCHIVE_BLOCK_BYTES || i + 1 == reservations.size()) {
+                appendBlock(raw, i + 1 - first, reservations[first].referenceNumber.value,
+                            reservations[i].referenceNumber.value, blocksOut);
+                raw.clear();
+                first = i + 1;
+            }
+        }
+
+        error_code ec;
+        if (filesystem::exists(filename, ec) && filesystem::file_size(filename, ec) != validBytes) {
+            filesystem::resize_file(filename, validBytes, ec);
+            if (ec) {
+                cerr << "Error: Could not repair " << filename << ".\n";
+                return false;
+            }
+        }
+        FILE* outFile = fopen(filename.c_str(), "ab");
+        if (outFile == nullptr) {
+            cerr << "Error: Could not open file " << filename << " for writing.\n";
+            return false;
+        }
+        bool ok = fwrite(blocksOut.data(), 1, blocksOut.size(), outFile) == blocksOut.size() && syncFile(outFile);
+        fclose(outFile);
+        if (!ok) cerr << "Error: Failed while appending to " << filename << ".\n";
+        return ok;
+    }
+
+private:
+    // Decompresses a block and passes each reservation to visit; false if the block is damaged
+    template <typename Visitor>
+    bool decodeBlock(const ArchiveBlockHeader* block, Visitor& visit) const {
+        const char* payload = reinterpret_cast<const char*>(block + 1);
+        string raw;
+        if (crc32c(payload, block->compressedBytes) != block->payloadCrc ||
+            !lzDecompress(payload, block->compressedBytes, block->rawBytes, raw)) {
+            return false;
+        }
+        const char* pos = raw.data();
+        const char* end = raw.data() + raw.size();
+        for (uint32_t i = 0; i < block->reservationCount; ++i) {
+            Reservation res;
+            if (!decodeReservation(pos, end, res)) return false;
+            visit(res);
+        }
+        return true;
+    }
+
+    static void appendBlock(const string& raw, size_t count, uint64_t minKey, uint64_t maxKey, string& out) {
+        string compressed = lzCompress(raw.data(), raw.size());
+        ArchiveBlockHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+        header.version = ARCHIVE_VERSION;
+        header.reservationCount = static_cast<uint32_t>(count);
+        header.minKey = minKey;
+        header.maxKey = maxKey;
+        header.rawBytes = static_cast<uint32_t>(raw.size());
+        header.compressedBytes = static_cast<uint32_t>(compressed.size());
+        header.payloadCrc = crc32c(compressed.data(), compressed.size());
+        header.headerCrc = crc32c(&header, sizeof(header));
+        out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+        out += compressed;
+    }
+
+    MappedFile file;
+    vector<const ArchiveBlockHeader*> blocks;
+    size_t totalReservations = 0;
+    uint64_t intactBytes = 0;
+};
+
+ColdArchive coldArchive; // Opened by loadStore()
+
+// --- Reference Hash Index ---
+
+/**
+ * @brief Open-addressing (linear probing) hash index from reference number to reservation slot.
+ * Each bucket keeps the packed key next to the slot, so probes compare integers and never touch
+ * the reservations themselves. The index refers into a reservation vector and must be updated
+ * whenever that vector changes.
+ */
+class RefHashIndex {
+public:
+    void clear() {
+        buckets.clear();
+        count = 0;
+    }
+
+    size_t size() const { return count; }
+
+    // Makes room for n entries without growing again
+    void reserve(size_t n) {
+        size_t capacity = 16;
+        while (capacity * MAX_LOAD_TENTHS < n * 10) capacity *= 2;
+        if (capacity > buckets.size()) rehash(capacity);
+    }
+
+    // Indexes every reservation of a vector, replacing the previous contents
+    void build(const vector<Reservation>& reservations) {
+        clear();
+        reserve(reservations.size());
+        for (size_t slot = 0; slot < reservations.size(); ++slot) insert(reservations, slot);
+    }
+
+    /**
+     * @brief Adds reservations[slot] to the index.
+     * A reference number that is already indexed is pointed at the newer slot.
+     * @param reservations The indexed vector.
+     * @param slot Position of the new reservation.
+     */
+    void insert(const vector<Reservation>& reservations, size_t slot) {
+        if ((count + 1) * 10 > buckets.size() * MAX_LOAD_TENTHS) rehash(max<size_t>(16, buckets.size() * 2));
+        uint64_t key = reservations[slot].referenceNumber.value;
+        size_t mask = buckets.size() - 1;
+        for (size_t i = hashKey(key) & mask;; i = (i + 1) & mask) {
+            Bucket& bucket = buckets[i];
+            if (bucket.slot == EMPTY) {
+                bucket.key = key;
+                bucket.slot = slot;
+                ++count;
+                return;
+            }
+            if (bucket.key == key) {
+                bucket.slot = slot;
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Looks up a reference number in expected O(1).
+     * @param refNum The reference number to find.
+     * @return The slot of the reservation, or -1 if it is not indexed.
+     */
+    int find(RefKey refNum) const {
+        if (buckets.empty()) return -1;
+        return probe(hashKey(refNum.value) & (buckets.size() - 1), refNum.value);
+    }
+
+    /**
+     * @brief Looks up many reference numbers, overlapping their cache misses.
+     * While one key is probed, the home bucket of the key PREFETCH_DISTANCE places further on is
+     * prefetched, so that many misses are in flight at once instead of one after another.
+     * @param refs The reference numbers.
+     * @param count Number of reference numbers.
+     * @param slots Receives the slot for each reference number, or -1 (same order as refs).
+     */
+    void findBatch(const RefKey* refs, size_t count, int* slots) const {
+        if (buckets.empty()) {
+            fill(slots, slots + count, -1);
+            return;
+        }
+        size_t mask = buckets.size() - 1;
+        size_t homes[PREFETCH_DISTANCE]; // Ring of the buckets already prefetched
+        for (size_t i = 0; i < count && i < PREFETCH_DISTANCE; ++i) {
+            homes[i] = hashKey(refs[i].value) & mask;
+            prefetchRead(&buckets[homes[i]]);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            size_t home = homes[i % PREFETCH_DISTANCE];
+            if (i + PREFETCH_DISTANCE < count) {
+                size_t ahead = hashKey(refs[i + PREFETCH_DISTANCE].value) & mask;
+                homes[i % PREFETCH_DISTANCE] = ahead;
+                prefetchRead(&buckets[ahead]);
+            }
+            slots[i] = probe(home, refs[i].value);
+        }
+    }
+
+private:
+    static const uint64_t EMPTY = numeric_limits<uint64_t>::max();
+    static const size_t MAX_LOAD_TENTHS = 7; // Grow beyond 70% occupancy
+    static const size_t PREFETCH_DISTANCE = 16; // Lookups ahead whose buckets findBatch prefetches
+
+    struct Bucket {
+        uint64_t key = 0;
+        uint64_t slot = EMPTY;
+    };
+
+    // Avalanche of the packed key; generated keys share their "RB" prefix and character set, so
+    // the low bits used for the bucket must depend on every byte
+    static uint64_t hashKey(uint64_t key) {
+        uint64_t hash = key;
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdull;
+        hash ^= hash >> 33;
+        hash *= 0xc4ceb9fe1a85ec53ull;
+        hash *= 0xff51afd7ed558ccdull;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    // Linear probe for key starting at its home bucket
+    int probe(size_t home, uint64_t key) const {
+        size_t mask = buckets.size() - 1;
+        for (size_t i = home;; i = (i + 1) & mask) {
+            const Bucket& bucket = buckets[i];
+            if (bucket.slot == EMPTY) return -1;
+            if (bucket.key == key) return static_cast<int>(bucket.slot);
+        }
+    }
+
+    void rehash(size_t capacity) {
+        vector<Bucket> old;
+        old.swap(buckets);
+        buckets.assign(capacity, Bucket());
+        size_t mask = capacity - 1;
+        for (const Bucket& bucket : old) {
+            if (bucket.slot == EMPTY) continue;
+            size_t i = hashKey(bucket.key) & mask;
+            while (buckets[i].slot != EMPTY) i = (i + 1) & mask;
+            buckets[i] = bucket;
+        }
+    }
+
+    vector<Bucket> buckets; // Power-of-two sized
+    size_t count = 0;
+};
+
+// --- Sorted Reference Index ---
+
+/**
+ * @brief Reference numbers in sorted order, maintained on every insert.
+ * Entries live in one large sorted array plus a small sorted insert buffer. A new reference goes
+ * into the buffer, which is merged into the array once it outgrows about sqrt(n) entries, so an
+ * insert costs amortized O(sqrt n), a lookup is two binary searches and nothing is ever copied
+ * or re-sorted per query. Like RefHashIndex it refers to slots of a reservation vector.
+ */
+class RefSortedIndex {
+public:
+    void clear() {
+        entries.clear();
+        buffer.clear();
+    }
+
+    size_t size() const { return entries.size() + buffer.size(); }
+
+    // Indexes every reservation of a vector, replacing the previous contents
+    void build(const vector<Reservation>& reservations) {
+        clear();
+        entries.reserve(reservations.size());
+        for (size_t slot = 0; slot < reservations.size(); ++slot) {
+            entries.push_back({ reservations[slot].referenceNumber.value, slot });
+        }
+        sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+            return a.key != b.key ? a.key < b.key : a.slot > b.slot; // Newest slot first among duplicates
+        });
+        entries.erase(unique(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.key == b.key; }),
+                      entries.end());
+    }
+
+    /**
+     * @brief Adds reservations[slot] to the index.
+     * A reference number that is already indexed is pointed at the newer slot.
+     * @param reservations The indexed vector.
+     * @param slot Position of the new reservation.
+     */
+    void insert(const vector<Reservation>& reservations, size_t slot) {
+        uint64_t key = reservations[slot].referenceNumber.value;
+        auto existing = lowerBound(entries, key);
+        if (existing != entries.end() && existing->key == key) {
+            existing->slot = slot;
+            return;
+        }
+        auto position = lowerBound(buffer, key);
+        if (position != buffer.end() && position->key == key) {
+            position->slot = slot;
+            return;
+        }
+        buffer.insert(position, { key, slot });
+        if (buffer.size() * buffer.size() > max<size_t>(entries.size(), MIN_BUFFER * MIN_BUFFER)) mergeBuffer();
+    }
+
+    /**
+     * @brief Adds reservations[firstSlot..] to the index.
+     * Large batches (imports) are cheaper to index by rebuilding than one insert at a time.
+     * @param reservations The indexed vector.
+     * @param firstSlot Position of the first new reservation.
+     */
+    void insertRange(const vector<Reservation>& reservations, size_t firstSlot) {
+        size_t added = reservations.size() - firstSlot;
+        if (added * added > max<size_t>(size(), MIN_BUFFER * MIN_BUFFER)) {
+            build(reservations);
+            return;
+        }
+        for (size_t slot = firstSlot; slot < reservations.size(); ++slot) insert(reservations, slot);
+    }
+
+    /**
+     * @brief Looks up a reference number by binary search in O(log n).
+     * @param refNum The reference number to find.
+     * @return The slot of the reservation, or -1 if it is not indexed.
+     */
+    int find(RefKey refNum) const {
+        auto bufferHit = lowerBound(buffer, refNum.value);
+        if (bufferHit != buffer.end() && bufferHit->key == refNum.value) return static_cast<int>(bufferHit->slot);
+        auto hit = lowerBound(entries, refNum.value);
+        if (hit != entries.end() && hit->key == refNum.value) return static_cast<int>(hit->slot);
+        return -1;
+    }
+
+    /**
+     * @brief Calls visit(slot) for every indexed reference number in [first, last], in order.
+     * @param first Smallest reference number to include.
+     * @param last Largest reference number to include.
+     * @param visit Called with the slot of each reservation in the range.
+     * @return Number of reservations visited.
+     */
+    template <typename Visitor>
+    size_t forEachInRange(RefKey first, RefKey last, Visitor visit) const {
+        auto a = lowerBound(entries, first.value);
+        auto b = lowerBound(buffer, first.value);
+        size_t visited = 0;
+        while (true) { // Merge of the two sorted runs
+            bool useA = a != entries.end() && a->key <= last.value;
+            bool useB = b != buffer.end() && b->key <= last.value;
+            if (!useA && !useB) break;
+            if (useA && (!useB || a->key < b->key)) {
+                visit(static_cast<size_t>(a->slot));
+                ++a;
+            } else {
+                visit(static_cast<size_t>(b->slot));
+                ++b;
+            }
+            ++visited;
+        }
+        return visited;
+    }
+
+private:
+    static const size_t MIN_BUFFER = 64; // Buffer capacity while the array is small
+
+    struct Entry {
+        uint64_t key;  // RefKey::value
+        uint64_t slot; // Position in the reservation vector
+    };
+
+    template <typename Vector>
+    static auto lowerBound(Vector& run, uint64_t key) -> decltype(run.begin()) {
+        return lower_bound(run.begin(), run.end(), key, [](const Entry& entry, uint64_t value) { return entry.key < value; });
+    }
+
+    // Folds the insert buffer into the sorted array (keys in the two never overlap)
+    void mergeBuffer() {
+        vector<Entry> merged;
+        merged.reserve(entries.size() + buffer.size());
+        merge(entries.begin(), entries.end(), buffer.begin(), buffer.end(), back_inserter(merged),
+              [](const Entry& a, const Entry& b) { return a.key < b.key; });
+        entries.swap(merged);
+        buffer.clear();
+    }
+
+    vector<Entry> entries; // Sorted by key
+    vector<Entry> buffer;  // Sorted by key, recent inserts
+};
+
+// --- Eytzinger Reference Index ---
+
+/**
+ * @brief Read-optimized search index storing the sorted reference keys in Eytzinger (BFS) order.
+ * Node k's children are 2k and 2k+1, so the first levels of the search tree share a few cache lines
+ * and each descent step moves forward in memory. The eight nodes three levels below the current
+ * node share one 64-byte line, which is prefetched while the next levels are compared, so the
+ * memory latency of a lookup overlaps instead of adding up probe by probe as in binarySearch().
+ * Inserts would need a full rebuild, so the index is built from a snapshot of the sorted index.
+ */
+class RefEytzingerIndex {
+public:
+    size_t size() const { return count; }
+
+    /**
+     * @brief Lays out the reference numbers of a sorted index in Eytzinger order.
+     * @param sorted The sorted index (its newest slot per reference number is kept).
+     * @param reservations The vector the sorted index refers to.
+     */
+    void build(const RefSortedIndex& sorted, const vector<Reservation>& reservations) {
+        vector<uint64_t> sortedKeys, sortedSlots;
+        sortedKeys.reserve(sorted.size());
+        sortedSlots.reserve(sorted.size());
+        sorted.forEachInRange(RefKey(0), RefKey(numeric_limits<uint64_t>::max()), [&](size_t slot) {
+            sortedKeys.push_back(reservations[slot].referenceNumber.value);
+            sortedSlots.push_back(slot);
+        });
+        build(sortedKeys, sortedSlots);
+    }
+
+    /**
+     * @brief Lays out sorted, distinct keys in Eytzinger order.
+     * @param sortedKeys The keys in ascending order.
+     * @param sortedSlots The slot belonging to each key.
+     */
+    void build(const vector<uint64_t>& sortedKeys, const vector<uint64_t>& sortedSlots) {
+        count = sortedKeys.size();
+
+        // Node 0 is unused; the array starts on a cache line so node 8k begins one
+        storage.assign(count + 1 + CACHE_LINE_KEYS, 0);
+        size_t misalignment = (reinterpret_cast<uintptr_t>(storage.data()) / sizeof(uint64_t)) % CACHE_LINE_KEYS;
+        keyOffset = misalignment == 0 ? 0 : CACHE_LINE_KEYS - misalignment;
+        uint64_t* keys = storage.data() + keyOffset;
+        slots.assign(count + 1, 0);
+
+        // An in-order walk of the implicit tree visits the nodes in ascending key order
+        size_t next = 0;
+        size_t k = 1;
+        vector<size_t> stack;
+        while (next < count) {
+            while (k <= count) {
+                stack.push_back(k);
+                k = 2 * k;
+            }
+            k = stack.back();
+            stack.pop_back();
+            keys[k] = sortedKeys[next];
+            slots[k] = sortedSlots[next];
+            ++next;
+            k = 2 * k + 1;
+        }
+    }
+
+    /**
+     * @brief Looks up a reference number in O(log n).
+     * @param refNum The reference number to find.
+     * @param prefetch Prefetch the nodes three levels ahead (off only for benchmarking).
+     * @return The slot of the reservation, or -1 if it is not indexed.
+     */
+    int find(RefKey refNum, bool prefetch = true) const {
+        const uint64_t* keys = storage.data() + keyOffset;
+        size_t k = 1;
+        while (k <= count) {
+            if (prefetch) prefetchRead(keys + CACHE_LINE_KEYS * k); // Nodes 8k..8k+7, three levels down
+            k = 2 * k + (keys[k] < refNum.value ? 1 : 0);
+        }
+        // k has walked off the tree; the lower bound is the node where the search last went left,
+        // found by dropping the trailing right turns (1 bits) and that left turn
+#if defined(__GNUC__) || defined(__clang__)
+        k >>= __builtin_ffsll(static_cast<long long>(~k));
+#else
+        while (k & 1) k >>= 1;
+        k >>= 1;
+#endif
+        if (k == 0 || keys[k] != refNum.value) return -1;
+        return static_cast<int>(slots[k]);
+    }
+
+private:
+    static const size_t CACHE_LINE_KEYS = 8; // 64-byte line / 8-byte key
+
+    vector<uint64_t> storage; // Keys in Eytzinger order, node k at storage[keyOffset + k]
+    size_t keyOffset = 0;     // Aligns node 0 to a cache line (a copy may lose this, which only costs speed)
+    vector<uint64_t> slots;   // slots[k] is the reservation slot of keys[k]
+    size_t count = 0;
+};
+
+// --- Vectorized Key Scan ---
+//
+// A linear scan over a contiguous array of packed reference keys (RefKey::value). Comparing
+// 64-bit integers lets the CPU test 2 (SSE4.2) or 4 (AVX2) keys per instruction; the kernel is
+// picked once at runtime from what the CPU supports, with a portable scalar loop as the fallback.
+// All kernels return the index of the first matching key, or count if there is none.
+
+enum class KeyScanKernel { Scalar, Sse42, Avx2 };
+
+const char* keyScanKernelName(KeyScanKernel kernel) {
+    switch (kernel) {
+        case KeyScanKernel::Sse42: return "SSE4.2";
+        case KeyScanKernel::Avx2: return "AVX2";
+        default: return "Scalar";
+    }
+}
+
+// Scalar kernel, one key per comparison
+size_t scanKeysScalar(const uint64_t* keys, size_t count, uint64_t wanted) {
+    for (size_t i = 0; i < count; ++i) {
+        if (keys[i] == wanted) return i;
+    }
+    return count;
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define HAVE_SIMD_KEY_SCAN 1
+
+// SSE4.2 kernel, 8 keys (four 128-bit compares) per iteration
+TARGET_SSE42 size_t scanKeysSse42(const uint64_t* keys, size_t count, uint64_t wanted) {
+    const __m128i needle = _mm_set1_epi64x(static_cast<long long>(wanted));
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m128i* block = reinterpret_cast<const __m128i*>(keys + i);
+        __m128i a = _mm_cmpeq_epi64(_mm_loadu_si128(block), needle);
+        __m128i b = _mm_cmpeq_epi64(_mm_loadu_si128(block + 1), needle);
+        __m128i c = _mm_cmpeq_epi64(_mm_loadu_si128(block + 2), needle);
+        __m128i d = _mm_cmpeq_epi64(_mm_loadu_si128(block + 3), needle);
+        __m128i any = _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d));
+        if (!_mm_testz_si128(any, any)) break; // The match is in this block; the scalar tail locates it
+    }
+    return i + scanKeysScalar(keys + i, count - i, wanted);
+}
+
+// AVX2 kernel, 16 keys (four 256-bit compares) per iteration
+TARGET_AVX2 size_t scanKeysAvx2(const uint64_t* keys, size_t count, uint64_t wanted) {
+    const __m256i needle = _mm256_set1_epi64x(static_cast<long long>(wanted));
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m256i* block = reinterpret_cast<const __m256i*>(keys + i);
+        __m256i a = _mm256_cmpeq_epi64(_mm256_loadu_si256(block), needle);
+        __m256i b = _mm256_cmpeq_epi64(_mm256_loadu_si256(block + 1), needle);
+        __m256i c = _mm256_cmpeq_epi64(_mm256_loadu_si256(block + 2), needle);
+        __m256i d = _mm256_cmpeq_epi64(_mm256_loadu_si256(block + 3), needle);
+        __m256i any = _mm256_or_si256(_mm256_or_si256(a, b), _mm256_or_si256(c, d));
+        if (!_mm256_testz_si256(any, any)) break; // The match is in this block; the scalar tail locates it
+    }
+    return i + scanKeysScalar(keys + i, count - i, wanted);
+}
+#endif
+
+// True if this CPU can run the given kernel
+bool keyScanKernelSupported(KeyScanKernel kernel) {
+#ifdef HAVE_SIMD_KEY_SCAN
+    static const bool sse42 = cpuSupportsSse42();
+    static const bool avx2 = cpuSupportsAvx2();
+    return kernel == KeyScanKernel::Scalar || (kernel == KeyScanKernel::Sse42 && sse42) || (kernel == KeyScanKernel::Avx2 && avx2);
+#else
+    return kernel == KeyScanKernel::Scalar;
+#endif
+}
+
+// The fastest kernel this CPU supports
+KeyScanKernel bestKeyScanKernel() {
+    if (keyScanKernelSupported(KeyScanKernel::Avx2)) return KeyScanKernel::Avx2;
+    if (keyScanKernelSupported(KeyScanKernel::Sse42)) return KeyScanKernel::Sse42;
+    return KeyScanKernel::Scalar;
+}
+
+/**
+ * @brief Finds the first occurrence of a key in a contiguous key array.
+ * @param keys The keys to scan.
+ * @param count Number of keys.
+ * @param wanted The key to find.
+ * @param kernel The implementation to use; it must be supported by this CPU.
+ * @return The index of the first match, or count if there is none.
+ */
+size_t scanKeys(const uint64_t* keys, size_t count, uint64_t wanted, KeyScanKernel kernel = bestKeyScanKernel()) {
+#ifdef HAVE_SIMD_KEY_SCAN
+    if (kernel == KeyScanKernel::Avx2) return scanKeysAvx2(keys, count, wanted);
+    if (kernel == KeyScanKernel::Sse42) return scanKeysSse42(keys, count, wanted);
+#endif
+    return scanKeysScalar(keys, count, wanted);
+}
+
+// --- Passenger Name Index ---
+
+// A passenger found by name
+struct PassengerMatch {
+    size_t reservation; // Slot of the reservation
+    size_t passenger;   // Index into that reservation's passengers
+};
+
+/**
+ * @brief Normalizes a passenger name for indexing: upper case, single spaces, no outer spaces.
+ * @param name The name as typed at booking or at the counter.
+ * @return The normalized name.
+ */
+string normalizePassengerName(string_view name) {
+    string normalized;
+    normalized.reserve(name.size());
+    bool pendingSpace = false;
+    for (char c : name) {
+        if (isspace(static_cast<unsigned char>(c))) {
+            pendingSpace = !normalized.empty();
+            continue;
+        }
+        if (pendingSpace) normalized += ' ';
+        pendingSpace = false;
+        normalized += static_cast<char>(toupper(static_cast<unsigned char>(c)));
+    }
+    return normalized;
+}
+
+/**
+ * @brief Sorted index of normalized passenger names, for exact and prefix lookups.
+ * Uses the same layout as RefSortedIndex: a large sorted array plus a sorted insert buffer that is
+ * merged in once it outgrows about sqrt(n) entries. A lookup is two binary searches followed by a
+ * walk over the matching entries. Names are read without decoding lazily loaded passengers.
+ */
+class PassengerNameIndex {
+public:
+    void clear() {
+        entries.clear();
+        buffer.clear();
+    }
+
+    size_t size() const { return entries.size() + buffer.size(); }
+
+    // Indexes every passenger of every reservation, replacing the previous contents
+    void build(const vector<Reservation>& reservations) {
+        clear();
+        for (size_t slot = 0; slot < reservations.size(); ++slot) addEntries(reservations, slot, entries);
+        sort(entries.begin(), entries.end(), entryLess);
+    }
+
+    /**
+     * @brief Adds the passengers of reservations[slot] to the index.
+     * @param reservations The indexed vector.
+     * @param slot Position of the new reservation.
+     */
+    void insert(const vector<Reservation>& reservations, size_t slot) {
+        vector<Entry> added;
+        addEntries(reservations, slot, added);
+        for (auto& entry : added) {
+            auto position = upper_bound(buffer.begin(), buffer.end(), entry, entryLess);
+            buffer.insert(position, move(entry));
+        }
+        if (buffer.size() * buffer.size() > max<size_t>(entries.size(), MIN_BUFFER * MIN_BUFFER)) mergeBuffer();
+    }
+
+    /**
+     * @brief Adds the passengers of reservations[firstSlot..] to the index.
+     * Large batches (imports) are cheaper to index by rebuilding than one insert at a time.
+     * @param reservations The indexed vector.
+     * @param firstSlot Position of the first new reservation.
+     */
+    void insertRange(const vector<Reservation>& reservations, size_t firstSlot) {
+        size_t added = reservations.size() - firstSlot;
+        if (added * added > max<size_t>(size(), MIN_BUFFER * MIN_BUFFER)) {
+            build(reservations);
+            return;
+        }
+        for (size_t slot = firstSlot; slot < reservations.size(); ++slot) insert(reservations, slot);
+    }
+
+    /**
+     * @brief Finds passengers by name.
+     * @param name The name (normalized here).
+     * @param prefix True to match every name starting with name, false for exact matches.
+     * @param limit At most this many matches are returned.
+     * @return The matches in name order (then reservation and passenger order).
+     */
+    vector<PassengerMatch> find(string_view name, bool prefix, size_t limit) const {
+        string wanted = normalizePassengerName(name);
+        auto matches = [&](const Entry& entry) {
+            return prefix ? entry.name.compare(0, wanted.size(), wanted) == 0 : entry.name == wanted;
+        };
+        auto a = lowerBound(entries, wanted);
+        auto b = lowerBound(buffer, wanted);
+        vector<PassengerMatch> found;
+        while (found.size() < limit) { // Merge of the two sorted runs
+            bool useA = a != entries.end() && matches(*a);
+            bool useB = b != buffer.end() && matches(*b);
+            if (!useA && !useB) break;
+            const Entry& entry = (useA && (!useB || entryLess(*a, *b))) ? *a++ : *b++;
+            found.push_back({ entry.slot, entry.passenger });
+        }
+        return found;
+    }
+
+private:
+    static const size_t MIN_BUFFER = 64; // Buffer capacity while the array is small
+
+    struct Entry {
+        string name;        // Normalized name
+        uint32_t slot;      // Reservation slot
+        uint32_t passenger; // Passenger index within the reservation
+    };
+
+    static bool entryLess(const Entry& a, const Entry& b) {
+        int order = a.name.compare(b.name);
+        if (order != 0) return order < 0;
+        return a.slot != b.slot ? a.slot < b.slot : a.passenger < b.passenger;
+    }
+
+    static vector<Entry>::const_iterator lowerBound(const vector<Entry>& run, const string& name) {
+        return lower_bound(run.begin(), run.end(), name, [](const Entry& entry, const string& value) { return entry.name < value; });
+    }
+
+    static void addEntries(const vector<Reservation>& reservations, size_t slot, vector<Entry>& out) {
+        const PassengerList& passengers = reservations[slot].passengers;
+        for (size_t p = 0; p < passengers.size(); ++p) {
+            out.push_back({ normalizePassengerName(passengers.nameAt(p)), static_cast<uint32_t>(slot), static_cast<uint32_t>(p) });
+        }
+    }
+
+    // Folds the insert buffer into the sorted array
+    void mergeBuffer() {
+        vector<Entry> merged;
+        merged.reserve(entries.size() + buffer.size());
+        merge(make_move_iterator(entries.begin()), make_move_iterator(entries.end()), make_move_iterator(buffer.begin()),
+              make_move_iterator(buffer.end()), back_inserter(merged), entryLess);
+        entries.swap(merged);
+        buffer.clear();
+    }
+
+    vector<Entry> entries; // Sorted by entryLess
+    vector<Entry> buffer;  // Sorted by entryLess, recent inserts
+};
+
+// --- Fuzzy Name Search ---
+
+/**
+ * @brief Levenshtein distance between two strings, giving up early once it exceeds a bound.
+ * Only the diagonal band |i - j| <= maxDistance can stay within the bound, so the cost is
+ * O(length * maxDistance).
+ * @param a The first string.
+ * @param b The second string.
+ * @param maxDistance Distances above this are not computed exactly.
+ * @return The edit distance, or maxDistance + 1 if it is larger than maxDistance.
+ */
+int editDistance(string_view a, string_view b, int maxDistance) {
+    int n = static_cast<int>(a.size()), m = static_cast<int>(b.size());
+    if (abs(n - m) > maxDistance) return maxDistance + 1;
+    const int beyond = maxDistance + 1;
+    vector<int> previous(m + 1, beyond), current(m + 1, beyond);
+    for (int j = 0; j <= min(m, maxDistance); ++j) previous[j] = j;
+    for (int i = 1; i <= n; ++i) {
+        int from = max(1, i - maxDistance), to = min(m, i + maxDistance);
+        fill(current.begin(), current.end(), beyond);
+        if (i <= maxDistance) current[0] = i;
+        int rowBest = current[0];
+        for (int j = from; j <= to; ++j) {
+            int cost = a[i - 1] == b[j - 1] ? 0 : 1;
+            current[j] = min({ previous[j - 1] + cost, previous[j] + 1, current[j - 1] + 1, beyond });
+            rowBest = min(rowBest, current[j]);
+        }
+        if (rowBest > maxDistance) return beyond; // Every path already costs too much
+        previous.swap(current);
+    }
+    return min(previous[m], beyond);
+}
+
+// A passenger name found by a fuzzy search
+struct FuzzyNameMatch {
+    string name;  // Normalized name as indexed
+    int distance; // Edit distance to the query
+};
+
+/**
+ * @brief Trigram inverted index over the distinct normalized passenger names.
+ * Each name is padded ("  NAME ") and split into overlapping 3-character grams; every gram keeps a
+ * posting list of the names containing it. One edit destroys at most three grams, so a name within
+ * the edit bound shares at least `needed` of the query's grams and therefore appears in one of its
+ * (grams - needed + 1) rarest posting lists. Only those lists produce candidates; the common lists
+ * (e.g. the first-letter grams) are merely probed for them. Candidates sharing enough grams are
+ * ranked by Levenshtein distance. Names are only added; the index is rebuilt when reservations leave.
+ */
+class NameTrigramIndex {
+public:
+    void clear() {
+        nameIds.clear();
+        names.clear();
+        postings.clear();
+        counts.clear();
+    }
+
+    size_t size() const { return names.size(); }
+
+    // Adds a passenger name (normalized here); names already indexed are ignored
+    void add(string_view name) {
+        string normalized = normalizePassengerName(name);
+        if (normalized.empty()) return;
+        auto inserted = nameIds.emplace(normalized, static_cast<uint32_t>(names.size()));
+        if (!inserted.second) return;
+        uint32_t id = inserted.first->second;
+        names.push_back(move(normalized));
+        for (uint32_t gram : gramsOf(names.back())) {
+            vector<uint32_t>& list = postings[gram];
+            if (list.empty() || list.back() != id) list.push_back(id); // Ids only grow, so lists stay sorted
+        }
+    }
+
+    // Indexes every passenger name of a reservation
+    void addReservation(const Reservation& res) {
+        for (size_t p = 0; p < res.passengers.size(); ++p) add(res.passengers.nameAt(p));
+    }
+
+    /**
+     * @brief Finds the indexed names closest to a possibly misspelled query.
+     * Uses scratch buffers, so calls must not run concurrently.
+     * @param query The name as typed.
+     * @param maxDistance Largest edit distance accepted.
+     * @param limit At most this many names are returned.
+     * @return The names, closest first (ties in name order).
+     */
+    vector<FuzzyNameMatch> search(string_view query, int maxDistance, size_t limit) {
+        string wanted = normalizePassengerName(query);
+        vector<FuzzyNameMatch> found;
+        if (wanted.empty() || names.empty()) return found;
+
+        vector<uint32_t> grams = gramsOf(wanted);
+        int needed = max(1, static_cast<int>(grams.size()) - 3 * maxDistance);
+        static const vector<uint32_t> noNames;
+        vector<const vector<uint32_t>*> lists;
+        for (uint32_t gram : grams) {
+            auto list = postings.find(gram);
+            lists.push_back(list == postings.end() ? &noNames : &list->second);
+        }
+        sort(lists.begin(), lists.end(), [](const vector<uint32_t>* a, const vector<uint32_t>* b) { return a->size() < b->size(); });
+
+        if (counts.size() < names.size()) counts.resize(names.size(), 0);
+        vector<uint32_t> touched, candidates;
+        size_t candidateLists = lists.size() - needed + 1;
+        for (size_t l = 0; l < lists.size(); ++l) {
+            if (l < candidateLists) {
+                for (uint32_t id : *lists[l]) {
+                    if (counts[id]++ == 0) touched.push_back(id);
+                }
+            } else if (lists[l]->size() < touched.size() * 16) { // Cheaper to walk the list than to search it
+                for (uint32_t id : *lists[l]) {
+                    if (counts[id] != 0) ++counts[id];
+                }
+            } else {
+                for (uint32_t id : touched) {
+                    if (binary_search(lists[l]->begin(), lists[l]->end(), id)) ++counts[id];
+                }
+            }
+        }
+        for (uint32_t id : touched) {
+            if (counts[id] >= needed) candidates.push_back(id);
+            counts[id] = 0; // Leave the scratch buffer clean for the next query
+        }
+        for (uint32_t id : candidates) {
+            int distance = editDistance(wanted, names[id], maxDistance);
+            if (distance <= maxDistance) found.push_back({ names[id], distance });
+        }
+        sort(found.begin(), found.end(), [](const FuzzyNameMatch& a, const FuzzyNameMatch& b) {
+            return a.distance != b.distance ? a.distance < b.distance : a.name < b.name;
+        });
+        if (found.size() > limit) found.resize(limit);
+        return found;
+    }
+
+private:
+    // The distinct trigrams of a padded name, each packed into the low 24 bits of an integer
+    static vector<uint32_t> gramsOf(const string& name) {
+        string padded = "  " + name + " ";
+        vector<uint32_t> grams;
+        grams.reserve(padded.size() - 2);
+        for (size_t i = 0; i + 3 <= padded.size(); ++i) {
+            grams.push_back((static_cast<uint32_t>(static_cast<unsigned char>(padded[i])) << 16) |
+                            (static_cast<uint32_t>(static_cast<unsigned char>(padded[i + 1])) << 8) |
+                            static_cast<unsigned char>(padded[i + 2]));
+        }
+        sort(grams.begin(), grams.end());
+        grams.erase(unique(grams.begin(), grams.end()), grams.end());
+        return grams;
+    }
+
+    unordered_map<string, uint32_t> nameIds;           // Normalized name -> id
+    vector<string> names;                              // Id -> normalized name
+    unordered_map<uint32_t, vector<uint32_t>> postings; // Trigram -> ids of the names containing it
+    vector<uint16_t> counts;                           // Scratch: grams shared with the current query (all 0 between queries)
+};
+
+// --- Bitmap Indexes ---
+
+/**
+ * @brief Compressed set of 32-bit reservation ids (Roaring-style).
+ * Ids are grouped by their upper 16 bits into containers of up to 65536 values. A sparse
+ * container stores its sorted low 16 bits (2 bytes per id); once it holds more than 4096 ids it
+ * switches to a 8 KB bitmap, which is smaller from then on. Intersections and unions work
+ * container by container, with word-wide AND/OR between bitmaps.
+ */
+class CompressedBitmap {
+public:
+    // Adds an id; appending in increasing order (new bookings) is the fast path
+    void add(uint32_t value) {
+        uint16_t high = static_cast<uint16_t>(value >> 16), low = static_cast<uint16_t>(value & 0xFFFF);
+        Container& container = containerFor(high);
+        if (!container.bits.empty()) {
+            uint64_t mask = uint64_t(1) << (low & 63);
+            if (!(container.bits[low >> 6] & mask)) {
+                container.bits[low >> 6] |= mask;
+                ++container.count;
+            }
+            return;
+        }
+        vector<uint16_t>& values = container.values;
+        if (values.empty() || values.back() < low) {
+            values.push_back(low);
+        } else {
+            auto position = lower_bound(values.begin(), values.end(), low);
+            if (*position == low) return;
+            values.insert(position, low);
+        }
+        ++container.count;
+        if (container.count > ARRAY_LIMIT) toBits(container);
+    }
+
+    bool contains(uint32_t value) const {
+        uint16_t high = static_cast<uint16_t>(value >> 16), low = static_cast<uint16_t>(value & 0xFFFF);
+        auto container = lower_bound(containers.begin(), containers.end(), high,
+                                     [](const Container& c, uint16_t h) { return c.high < h; });
+        if (container == containers.end() || container->high != high) return false;
+        if (!container->bits.empty()) return (container->bits[low >> 6] >> (low & 63)) & 1;
+        return binary_search(container->values.begin(), container->values.end(), low);
+    }
+
+    size_t cardinality() const {
+        size_t total = 0;
+        for (const auto& container : containers) total += container.count;
+        return total;
+    }
+
+    // Approximate heap memory used by the set
+    size_t memoryBytes() const {
+        size_t total = containers.capacity() * sizeof(Container);
+        for (const auto& container : containers) {
+            total += container.values.capacity() * sizeof(uint16_t) + container.bits.capacity() * sizeof(uint64_t);
+        }
+        return total;
+    }
+
+    // Calls visit(id) for every id in increasing order
+    template <typename Visitor>
+    void forEach(Visitor visit) const {
+        for (const auto& container : containers) {
+            uint32_t base = static_cast<uint32_t>(container.high) << 16;
+            if (container.bits.empty()) {
+                for (uint16_t low : container.values) visit(base | low);
+                continue;
+            }
+            for (size_t w = 0; w < container.bits.size(); ++w) {
+                for (uint64_t word = container.bits[w]; word != 0; word &= word - 1) {
+                    visit(base | static_cast<uint32_t>(w * 64 + lowestBit64(word)));
+                }
+            }
+        }
+    }
+
+    // The ids present in both sets
+    static CompressedBitmap intersect(const CompressedBitmap& a, const CompressedBitmap& b) {
+        CompressedBitmap result;
+        size_t i = 0, j = 0;
+        while (i < a.containers.size() && j < b.containers.size()) {
+            const Container& x = a.containers[i];
+            const Container& y = b.containers[j];
+            if (x.high != y.high) {
+                (x.high < y.high ? i : j)++;
+                continue;
+            }
+            Container c;
+            c.high = x.high;
+            if (!x.bits.empty() && !y.bits.empty()) {
+                c.bits.resize(BITMAP_WORDS);
+                for (size_t w = 0; w < BITMAP_WORDS; ++w) {
+                    c.bits[w] = x.bits[w] & y.bits[w];
+                    c.count += popcount64(c.bits[w]);
+                }
+                if (c.count <= ARRAY_LIMIT) toValues(c);
+            } else if (x.bits.empty() && y.bits.empty()) {
+                set_intersection(x.values.begin(), x.values.end(), y.values.begin(), y.values.end(), back_inserter(c.values));
+                c.count = static_cast<uint32_t>(c.values.size());
+            } else {
+                const Container& sparse = x.bits.empty() ? x : y;
+                const Container& dense = x.bits.empty() ? y : x;
+                for (uint16_t low : sparse.values) {
+                    if ((dense.bits[low >> 6] >> (low & 63)) & 1) c.values.push_back(low);
+                }
+                c.count = static_cast<uint32_t>(c.values.size());
+            }
+            if (c.count != 0) result.containers.push_back(move(c));
+            ++i;
+            ++j;
+        }
+        return result;
+    }
+
+    // The ids present in either set
+    static CompressedBitmap unite(const CompressedBitmap& a, const CompressedBitmap& b) {
+        CompressedBitmap result;
+        size_t i = 0, j = 0;
+        while (i < a.containers.size() || j < b.containers.size()) {
+            if (j == b.containers.size() || (i < a.containers.size() && a.containers[i].high < b.containers[j].high)) {
+                result.containers.push_back(a.containers[i++]);
+                continue;
+            }
+            if (i == a.containers.size() || b.containers[j].high < a.containers[i].high) {
+                result.containers.push_back(b.containers[j++]);
+                continue;
+            }
+            const Container& x = a.containers[i++];
+            const Container& y = b.containers[j++];
+            Container c;
+            c.high = x.high;
+            if (x.bits.empty() && y.bits.empty()) {
+                set_union(x.values.begin(), x.values.end(), y.values.begin(), y.values.end(), back_inserter(c.values));
+                c.count = static_cast<uint32_t>(c.values.size());
+                if (c.count > ARRAY_LIMIT) toBits(c);
+            } else {
+                c.bits.assign(BITMAP_WORDS, 0);
+                for (const Container* part : { &x, &y }) {
+                    if (part->bits.empty()) {
+                        for (uint16_t low : part->values) c.bits[low >> 6] |= uint64_t(1) << (low & 63);
+                    } else {
+                        for (size_t w = 0; w < BITMAP_WORDS; ++w) c.bits[w] |= part->bits[w];
+                    }
+                }
+                for (uint64_t word : c.bits) c.count += popcount64(word);
+            }
+            result.containers.push_back(move(c));
+        }
+        return result;
+    }
+
+private:
+    static const uint32_t ARRAY_LIMIT = 4096;   // Largest sparse container (8 KB, the size of a bitmap)
+    static const size_t BITMAP_WORDS = 1024;    // 65536 bits
+
+    struct Container {
+        uint16_t high = 0;        // Upper 16 bits of every id in the container
+        uint32_t count = 0;       // Ids in the container
+        vector<uint16_t> values;  // Sorted low 16 bits while sparse
+        vector<uint64_t> bits;    // Bitmap of low 16 bits once dense (then values is empty)
+    };
+
+    Container& containerFor(uint16_t high) {
+        if (!containers.empty() && containers.back().high == high) return containers.back();
+        auto position = lower_bound(containers.begin(), containers.end(), high,
+                                    [](const Container& c, uint16_t h) { return c.high < h; });
+        if (position == containers.end() || position->high != high) {
+            position = containers.insert(position, Container());
+            position->high = high;
+        }
+        return *position;
+    }
+
+    static void toBits(Container& container) {
+        container.bits.assign(BITMAP_WORDS, 0);
+        for (uint16_t low : container.values) container.bits[low >> 6] |= uint64_t(1) << (low & 63);
+        vector<uint16_t>().swap(container.values);
+    }
+
+    static void toValues(Container& container) {
+        container.values.clear();
+        for (size_t w = 0; w < BITMAP_WORDS; ++w) {
+            for (uint64_t word = container.bits[w]; word != 0; word &= word - 1) {
+                container.values.push_back(static_cast<uint16_t>(w * 64 + lowestBit64(word)));
+            }
+        }
+        vector<uint64_t>().swap(container.bits);
+    }
+
+    vector<Container> containers; // Sorted by high
+};
+
+/**
+ * @brief One CompressedBitmap of reservation slots per distinct value of a field.
+ */
+class BitmapIndex {
+public:
+    void clear() { bitmaps.clear(); }
+
+    void add(const string& value, size_t slot) { bitmaps[value].add(static_cast<uint32_t>(slot)); }
+
+    // The indexed values, in order
+    vector<string> values() const {
+        vector<string> out;
+        for (const auto& entry : bitmaps) out.push_back(entry.first);
+        return out;
+    }
+
+    // The slots whose field equals any of the values
+    CompressedBitmap anyOf(const vector<string>& values) const {
+        CompressedBitmap result;
+        for (const auto& value : values) {
+            auto bitmap = bitmaps.find(value);
+            if (bitmap != bitmaps.end()) result = CompressedBitmap::unite(result, bitmap->second);
+        }
+        return result;
+    }
+
+    size_t memoryBytes() const {
+        size_t total = 0;
+        for (const auto& entry : bitmaps) total += entry.second.memoryBytes();
+        return total;
+    }
+
+private:
+    map<string, CompressedBitmap> bitmaps;
+};
+
+// --- Seat Maps ---
+
+const int SEATS_PER_FLIGHT = 81; // Seats 1-81, as laid out by displaySeats()
+
+/**
+ * @brief Identifies a flight by what was booked: date, destination and departure time.
+ * @return The key SeatMapIndex files the flight under.
+ */
+string flightKey(const string& flightDate, const string& destination, const string& departureTime) {
+    return flightDate + '|' + destination + '|' + departureTime;
+}
+
+// The passenger holding a seat
+struct SeatOccupant {
+    static const uint32_t NONE = UINT32_MAX;
+
+    uint32_t reservation = NONE; // Slot of the reservation
+    uint32_t passenger = 0;      // Index into that reservation's passengers
+
+    bool isEmpty() const { return reservation == NONE; }
+};
+
+// Every booked seat of one flight
+struct FlightSeats {
+    array<SeatOccupant, SEATS_PER_FLIGHT> seats; // seats[n - 1] holds seat n
+    vector<pair<int, SeatOccupant>> doubleBooked; // Seats already held (or out of range) when booked, with the seat number
+    size_t occupied = 0;                          // Non-empty entries of seats
+};
+
+/**
+ * @brief Seat -> passenger map of every flight, for gate lookups and cabin manifests.
+ * Each flight has a dense array of SEATS_PER_FLIGHT (reservation, passenger) entries, so finding
+ * who is in a seat is one hash lookup and an array index, and a manifest is a walk over the cabin.
+ * Bookings only check seats within their own reservation, so two reservations can hold the same
+ * seat: the first keeps it and the others are listed in the flight's doubleBooked entries.
+ * Seats are read without decoding lazily loaded passengers.
+ */
+class SeatMapIndex {
+public:
+    void clear() {
+        flights.clear();
+        doubleBookings = 0;
+    }
+
+    size_t flightCount() const { return flights.size(); }
+    size_t doubleBookingCount() const { return doubleBookings; }
+
+    // Indexes every passenger of every reservation, replacing the previous contents
+    void build(const vector<Reservation>& reservations) {
+        clear();
+        for (size_t slot = 0; slot < reservations.size(); ++slot) insert(reservations, slot);
+    }
+
+    /**
+     * @brief Seats the passengers of reservations[slot] on their flight.
+     * @param reservations The indexed vector.
+     * @param slot Position of the new reservation.
+     */
+    void insert(const vector<Reservation>& reservations, size_t slot) {
+        const Reservation& res = reservations[slot];
+        FlightSeats& flight = flights[flightKey(res.flightDate, res.destination, res.departureTime)];
+        for (size_t p = 0; p < res.passengers.size(); ++p) {
+            SeatOccupant occupant;
+            occupant.reservation = static_cast<uint32_t>(slot);
+            occupant.passenger = static_cast<uint32_t>(p);
+            int seat = res.passengers.seatAt(p);
+            if (seat >= 1 && seat <= SEATS_PER_FLIGHT && flight.seats[seat - 1].isEmpty()) {
+                flight.seats[seat - 1] = occupant;
+                ++flight.occupied;
+            } else {
+                flight.doubleBooked.emplace_back(seat, occupant);
+                ++doubleBookings;
+            }
+        }
+    }
+
+    // A flight's seats, or nullptr if nobody is booked on it
+    const FlightSeats* find(const string& key) const {
+        auto flight = flights.find(key);
+        return flight == flights.end() ? nullptr : &flight->second;
+    }
+
+    /**
+     * @brief Lists the passengers booked in one seat of a flight.
+     * @param key The flight, from flightKey().
+     * @param seat The seat number.
+     * @return The seat's holder followed by any double bookings; empty if the seat is free.
+     */
+    vector<PassengerMatch> holders(const string& key, int seat) const {
+        vector<PassengerMatch> found;
+        const FlightSeats* flight = find(key);
+        if (!flight) return found;
+        if (seat >= 1 && seat <= SEATS_PER_FLIGHT && !flight->seats[seat - 1].isEmpty()) {
+            const SeatOccupant& occupant = flight->seats[seat - 1];
+            found.push_back({ occupant.reservation, occupant.passenger });
+        }
+        for (const auto& extra : flight->doubleBooked) {
+            if (extra.first == seat) found.push_back({ extra.second.reservation, extra.second.passenger });
+        }
+        return found;
+    }
+
+    size_t memoryBytes() const {
+        size_t total = flights.bucket_count() * sizeof(void*);
+        for (const auto& flight : flights) {
+            total += sizeof(flight) + flight.first.capacity() + flight.second.doubleBooked.capacity() * sizeof(pair<int, SeatOccupant>);
+        }
+        return total;
+    }
+
+private:
+    unordered_map<string, FlightSeats> flights;
+    size_t doubleBookings = 0; // Entries across every flight's doubleBooked list
+};
+
+// --- Reservation Queries ---
+//
+// A small filter language for ad-hoc questions about reservations, for example
+//     price > 3000 and destination = LONDON and kids >= 1
+// A query is a list of conditions joined by AND. A condition compares a field with a value
+// (=, !=, <, <=, >, >=) or lists the accepted values (destination in (PARIS, TOKYO)). Fields:
+//     destination, time, date   text; date is YYYY-MM-DD, so it orders correctly as text
+//     price, discount           amounts in RM
+//     adults, kids              passenger counts
+//     age, class                passenger fields: a reservation matches if one of its passengers
+//                               meets every age and class condition
+// Text may be quoted ('Economy Class'); it is compared without regard to case.
+// Compiling folds all conditions on a field into one range or value list, so running a query is a
+// single fused test per reservation with no per-condition dispatch. Destination and departure
+// time lists are resolved through the bitmap indexes, and only the reservations they leave are
+// scanned; any other query is a parallel scan.
+
+enum class QueryField { Destination, DepartureTime, FlightDate, TotalPrice, Discount, Adults, Kids, Age, TravelClass };
+
+// Inclusive range of numbers; the whole type until conditions narrow it
+template <typename T>
+struct QueryRange {
+    T low = numeric_limits<T>::lowest();
+    T high = numeric_limits<T>::max();
+
+    bool contains(T value) const { return value >= low && value <= high; }
+    bool isEmpty() const { return low > high; }
+    bool isNarrowed() const { return low != numeric_limits<T>::lowest() || high != numeric_limits<T>::max(); }
+};
+
+// The text values a field may take: an optional list of allowed values, rejected values and bounds
+struct QueryText {
+    bool restricted = false; // Only the values in allowed are accepted
+    vector<string> allowed;  // Sorted
+    vector<string> excluded; // Sorted
+    string low;              // Inclusive lower bound ("" = none)
+    string high;             // Exclusive upper bound ("" = none)
+
+    bool accepts(string_view value) const {
+        if (restricted && !binary_search(allowed.begin(), allowed.end(), value, less<>())) return false;
+        if (!excluded.empty() && binary_search(excluded.begin(), excluded.end(), value, less<>())) return false;
+        return (low.empty() || value >= low) && (high.empty() || value < high);
+    }
+
+    bool isEmpty() const { return (restricted && allowed.empty()) || (!low.empty() && !high.empty() && high <= low); }
+    bool isNarrowed() const { return restricted || !excluded.empty() || !low.empty() || !high.empty(); }
+};
+
+/**
+ * @brief A query after compilation: per field, the single range or value list it must satisfy.
+ */
+struct CompiledQuery {
+    QueryText destination, departureTime, flightDate, travelClass;
+    QueryRange<double> totalPrice, discount;
+    QueryRange<int> adults, kids, age;
+    bool never = false; // The conditions contradict each other, so nothing matches
+
+    /**
+     * @brief The fused predicate: tests the narrowed fields, cheapest first.
+     * Passenger fields are read without decoding lazily loaded passenger lists.
+     */
+    bool matches(const Reservation& res) const {
+        if ((checks & CHECK_COUNTS) && (!adults.contains(res.numAdults) || !kids.contains(res.numKids))) return false;
+        if ((checks & CHECK_AMOUNTS) && (!totalPrice.contains(res.totalPrice) || !discount.contains(res.discountApplied))) return false;
+        if ((checks & CHECK_DESTINATION) && !destination.accepts(res.destination)) return false;
+        if ((checks & CHECK_TIME) && !departureTime.accepts(res.departureTime)) return false;
+        if ((checks & CHECK_DATE) && !flightDate.accepts(res.flightDate)) return false;
+        if (!(checks & CHECK_PASSENGERS)) return true;
+        for (size_t i = 0; i < res.passengers.size(); ++i) {
+            if (age.contains(res.passengers.ageAt(i)) && (!travelClass.isNarrowed() || travelClass.accepts(res.passengers.travelClassAt(i)))) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Works out which tests matches() has to run; called once all conditions are in
+    void finish() {
+        checks = 0;
+        if (adults.isNarrowed() || kids.isNarrowed()) checks |= CHECK_COUNTS;
+        if (totalPrice.isNarrowed() || discount.isNarrowed()) checks |= CHECK_AMOUNTS;
+        if (destination.isNarrowed()) checks |= CHECK_DESTINATION;
+        if (departureTime.isNarrowed()) checks |= CHECK_TIME;
+        if (flightDate.isNarrowed()) checks |= CHECK_DATE;
+        if (age.isNarrowed() || travelClass.isNarrowed()) checks |= CHECK_PASSENGERS;
+        never = adults.isEmpty() || kids.isEmpty() || totalPrice.isEmpty() || discount.isEmpty() || age.isEmpty() ||
+                destination.isEmpty() || departureTime.isEmpty() || flightDate.isEmpty() || travelClass.isEmpty();
+    }
+
+private:
+    enum : unsigned {
+        CHECK_COUNTS = 1, CHECK_AMOUNTS = 2, CHECK_DESTINATION = 4, CHECK_TIME = 8, CHECK_DATE = 16, CHECK_PASSENGERS = 32
+    };
+    unsigned checks = 0;
+};
+
+// Splits a query into words, quoted text, operators, parentheses and commas
+bool tokenizeQuery(const string& text, vector<string>& tokens, string& error) {
+    size_t i = 0;
+    while (i < text.size()) {
+        char c = text[i];
+        if (isspace(static_cast<unsigned char>(c))) {
+            ++i;
+        } else if (c == '\'' || c == '"') {
+            size_t close = text.find(c, i + 1);
+            if (close == string::npos) {
+                error = "missing closing quote";
+                return false;
+            }
+            tokens.push_back(text.substr(i, close - i + 1)); // Keeps the quotes, so it is never read as a keyword
+            i = close + 1;
+        } else if (c == '(' || c == ')' || c == ',') {
+            tokens.push_back(string(1, c));
+            ++i;
+        } else if (c == '=' || c == '!' || c == '<' || c == '>') {
+            size_t length = (i + 1 < text.size() && text[i + 1] == '=') ? 2 : 1;
+            if (c == '!' && length == 1) {
+                error = "'!' must be followed by '='";
+                return false;
+            }
+            tokens.push_back(text.substr(i, length));
+            i += length;
+        } else {
+            size_t start = i;
+            while (i < text.size() && !isspace(static_cast<unsigned char>(text[i])) && !strchr("()=,!<>'\"", text[i])) ++i;
+            tokens.push_back(text.substr(start, i - start));
+        }
+    }
+    return true;
+}
+
+// Upper-cases a word, or strips the quotes from quoted text (kept as typed)
+string queryValue(const string& token) {
+    if (!token.empty() && (token[0] == '\'' || token[0] == '"')) return token.substr(1, token.size() - 2);
+    string upper = token;
+    transform(upper.begin(), upper.end(), upper.begin(), [](unsigned char c) { return static_cast<char>(toupper(c)); });
+    return upper;
+}
+
+// Writes a travel class the way bookings store it: "business" -> "Business Class"
+string canonicalTravelClass(string value) {
+    transform(value.begin(), value.end(), value.begin(), [](unsigned char c) { return static_cast<char>(tolower(c)); });
+    if (value.size() < 6 || value.compare(value.size() - 6, 6, " class") != 0) value += " class";
+    for (size_t i = 0; i < value.size(); ++i) {
+        if (i == 0 || value[i - 1] == ' ') value[i] = static_cast<char>(toupper(static_cast<unsigned char>(value[i])));
+    }
+    return value;
+}
+
+// Narrows a numeric range by one comparison; strict bounds become the next representable value
+template <typename T>
+void narrowRange(QueryRange<T>& range, const string& op, T value) {
+    T above = is_integral<T>::value ? value + 1 : nextafter(value, numeric_limits<T>::max());
+    T below = is_integral<T>::value ? value - 1 : nextafter(value, numeric_limits<T>::lowest());
+    if (op == "=" || op == ">=" || op == ">") range.low = max(range.low, op == ">" ? above : value);
+    if (op == "=" || op == "<=" || op == "<") range.high = min(range.high, op == "<" ? below : value);
+}
+
+// Narrows a text field by one comparison or list
+void narrowText(QueryText& text, const string& op, vector<string> values) {
+    sort(values.begin(), values.end());
+    values.erase(unique(values.begin(), values.end()), values.end());
+    if (op == "=" || op == "IN") {
+        if (text.restricted) {
+            vector<string> both;
+            set_intersection(text.allowed.begin(), text.allowed.end(), values.begin(), values.end(), back_inserter(both));
+            text.allowed.swap(both);
+        } else {
+            text.allowed = values;
+            text.restricted = true;
+        }
+    } else if (op == "!=") {
+        vector<string> merged;
+        set_union(text.excluded.begin(), text.excluded.end(), values.begin(), values.end(), back_inserter(merged));
+        text.excluded.swap(merged);
+    } else {
+        const string& value = values.front();
+        string justAfter = value + '\0'; // The smallest text that sorts after value
+        if (op == ">=" || op == ">") {
+            const string& bound = op == ">" ? justAfter : value;
+            if (text.low.empty() || bound > text.low) text.low = bound;
+        } else {
+            const string& bound = op == "<=" ? justAfter : value;
+            if (text.high.empty() || bound < text.high) text.high = bound;
+        }
+    }
+}
+
+/**
+ * @brief Parses and compiles a query.
+ * @param text The query, e.g. "price > 3000 and destination = LONDON and kids >= 1".
+ * @param query Receives the compiled query.
+ * @param error Receives a description of the first problem.
+ * @return False if the query is not valid.
+ */
+bool compileQuery(const string& text, CompiledQuery& query, string& error) {
+    static const map<string, QueryField> fields = {
+        { "DESTINATION", QueryField::Destination }, { "DEST", QueryField::Destination },
+        { "TIME", QueryField::DepartureTime }, { "DEPARTURETIME", QueryField::DepartureTime },
+        { "DATE", QueryField::FlightDate }, { "FLIGHTDATE", QueryField::FlightDate },
+        { "PRICE", QueryField::TotalPrice }, { "TOTALPRICE", QueryField::TotalPrice },
+        { "DISCOUNT", QueryField::Discount }, { "DISCOUNTAPPLIED", QueryField::Discount },
+        { "ADULTS", QueryField::Adults }, { "NUMADULTS", QueryField::Adults },
+        { "KIDS", QueryField::Kids }, { "NUMKIDS", QueryField::Kids },
+        { "AGE", QueryField::Age }, { "PASSENGER.AGE", QueryField::Age },
+        { "CLASS", QueryField::TravelClass }, { "PASSENGER.CLASS", QueryField::TravelClass },
+    };
+    query = CompiledQuery();
+    vector<string> tokens;
+    if (!tokenizeQuery(text, tokens, error)) return false;
+    if (tokens.empty()) {
+        error = "the query is empty";
+        return false;
+    }
+
+    size_t pos = 0;
+    while (true) {
+        auto field = pos < tokens.size() ? fields.find(queryValue(tokens[pos])) : fields.end();
+        if (field == fields.end()) {
+            error = pos < tokens.size() ? "unknown field '" + tokens[pos] + "'" : "a condition is missing after AND";
+            return false;
+        }
+        ++pos;
+        string op = pos < tokens.size() ? queryValue(tokens[pos]) : "";
+        if (op != "=" && op != "!=" && op != "<" && op != "<=" && op != ">" && op != ">=" && op != "IN") {
+            error = "expected a comparison after '" + tokens[pos - 1] + "'";
+            return false;
+        }
+        ++pos;
+
+        vector<string> values;
+        if (op == "IN") {
+            if (pos >= tokens.size() || tokens[pos] != "(") {
+                error = "expected '(' after IN";
+                return false;
+            }
+            ++pos;
+            while (pos < tokens.size() && tokens[pos] != ")") {
+                if (tokens[pos] != ",") values.push_back(queryValue(tokens[pos]));
+                ++pos;
+            }
+            if (pos == tokens.size() || values.empty()) {
+                error = "IN needs a list of values in parentheses";
+                return false;
+            }
+            ++pos;
+        } else {
+            if (pos >= tokens.size() || tokens[pos] == "(" || tokens[pos] == ")" || tokens[pos] == ",") {
+                error = "expected a value after '" + op + "'";
+                return false;
+            }
+            values.push_back(queryValue(tokens[pos++]));
+        }
+
+        switch (field->second) {
+            case QueryField::Destination:
+            case QueryField::DepartureTime:
+            case QueryField::FlightDate:
+            case QueryField::TravelClass: {
+                QueryText& target = field->second == QueryField::Destination     ? query.destination
+                                    : field->second == QueryField::DepartureTime ? query.departureTime
+                                    : field->second == QueryField::FlightDate    ? query.flightDate
+                                                                                 : query.travelClass;
+                for (auto& value : values) {
+                    if (field->second == QueryField::TravelClass) {
+                        value = canonicalTravelClass(value);
+                    } else if (field->second != QueryField::FlightDate) { // Stored destinations and times are upper case
+                        transform(value.begin(), value.end(), value.begin(), [](unsigned char c) { return static_cast<char>(toupper(c)); });
+                    }
+                }
+                narrowText(target, op, values);
+                break;
+            }
+            default: {
+                if (op == "IN" || op == "!=") {
+                    error = op + " is only supported for text fields";
+                    return false;
+                }
+                const string& value = values.front();
+                char* end = nullptr;
+                double number = strtod(value.c_str(), &end);
+                if (value.empty() || *end != '\0') {
+                    error = "'" + value + "' is not a number";
+                    return false;
+                }
+                if (field->second == QueryField::TotalPrice || field->second == QueryField::Discount) {
+                    narrowRange(field->second == QueryField::TotalPrice ? query.totalPrice : query.discount, op, number);
+                } else {
+                    if (number != floor(number) || fabs(number) > 1e9) {
+                        error = "'" + value + "' is not a whole number";
+                        return false;
+                    }
+                    QueryRange<int>& target = field->second == QueryField::Adults ? query.adults
+                                              : field->second == QueryField::Kids ? query.kids
+                                                                                  : query.age;
+                    narrowRange(target, op, static_cast<int>(number));
+                }
+                break;
+            }
+        }
+
+        if (pos == tokens.size()) break;
+        if (queryValue(tokens[pos]) != "AND") {
+            error = "expected AND before '" + tokens[pos] + "'";
+            return false;
+        }
+        ++pos;
+    }
+    query.finish();
+    return true;
+}
+
+/**
+ * @brief Runs a compiled query over reservations, splitting large inputs across threads.
+ * Each thread tests a contiguous share of the input and the shares are joined in order.
+ * @param query The compiled query.
+ * @param reservations The reservations to search.
+ * @param candidates Slots to test, in increasing order, or nullptr to test every reservation.
+ * @param threadCount Scan threads (0 = one per hardware thread).
+ * @return The matching slots, in increasing order.
+ */
+vector<size_t> executeQuery(const CompiledQuery& query, const vector<Reservation>& reservations,
+                            const vector<size_t>* candidates, unsigned threadCount = 0) {
+    if (query.never) return {};
+    const size_t minChunk = 16384; // Smaller inputs are not worth a thread
+    size_t total = candidates != nullptr ? candidates->size() : reservations.size();
+    if (threadCount == 0) threadCount = max(1u, thread::hardware_concurrency());
+    size_t chunkCount = min<size_t>(threadCount, max<size_t>(1, total / minChunk));
+
+    vector<vector<size_t>> chunkResults(chunkCount);
+    auto scan = [&](size_t chunk) {
+        size_t first = total * chunk / chunkCount, last = total * (chunk + 1) / chunkCount;
+        vector<size_t>& out = chunkResults[chunk];
+        for (size_t i = first; i < last; ++i) {
+            size_t slot = candidates != nullptr ? (*candidates)[i] : i;
+            if (query.matches(reservations[slot])) out.push_back(slot);
+        }
+    };
+    vector<thread> workers;
+    for (size_t i = 1; i < chunkCount; ++i) workers.emplace_back(scan, i);
+    scan(0); // The calling thread takes the first chunk
+    for (auto& worker : workers) worker.join();
+
+    vector<size_t> slots = move(chunkResults[0]);
+    for (size_t i = 1; i < chunkCount; ++i) slots.insert(slots.end(), chunkResults[i].begin(), chunkResults[i].end());
+    return slots;
+}
+
+// --- Reservation Store ---
+
+mutex bookingMutex;           // Serializes applying bookings so allReservations follows log order
+mutex reservationsMutex;      // Guards allReservations and the dirty tracking against the background checkpointer
+uint64_t appliedLogSequence = 0; // Log sequence of the newest booking present in allReservations; written under both mutexes
+condition_variable bookingApplied; // Signalled under bookingMutex when appliedLogSequence advances
+
+// Dirty tracking: slots of allReservations added or changed since the last snapshot save
+vector<size_t> dirtySlots;
+vector<uint8_t> dirtyFlags;   // dirtyFlags[slot] != 0 while the slot is listed in dirtySlots
+
+// Shape of reservations.dat as last written (guarded by the checkpoint mutex)
+SnapshotInfo snapshotState;
+bool snapshotExists = false;
+bool forceFullSnapshot = false; // Slots were renumbered (e.g. by archiving); guarded by reservationsMutex
+
+RefHashIndex refHashIndex;      // Reference number -> slot of allReservations; guarded by reservationsMutex
+RefSortedIndex refSortedIndex;  // Reference numbers in order -> slot of allReservations; guarded by reservationsMutex
+vector<uint64_t> referenceKeys; // referenceKeys[slot] is allReservations[slot]'s RefKey, for scans; guarded by reservationsMutex
+RefEytzingerIndex refEytzingerIndex; // Read-optimized copy of refSortedIndex, rebuilt on first use after a change
+bool eytzingerStale = true;     // allReservations changed since refEytzingerIndex was built; guarded by reservationsMutex
+PassengerNameIndex passengerNameIndex; // Normalized passenger names -> (slot, passenger); guarded by reservationsMutex
+NameTrigramIndex nameTrigramIndex; // Distinct passenger names for fuzzy search; guarded by reservationsMutex
+BitmapIndex destinationBitmaps; // Destination -> slots of allReservations; guarded by reservationsMutex
+BitmapIndex departureBitmaps;   // Departure time -> slots of allReservations; guarded by reservationsMutex
+SeatMapIndex seatMaps;          // Flight -> seat -> (slot, passenger); guarded by reservationsMutex
+RefBloomFilter refFilter;       // Every reference number, active or archived; guarded by reservationsMutex
+bool refFilterChanged = false;  // refFilter differs from REF_FILTER_FILE; guarded by reservationsMutex
+uint64_t refFilterRejections = 0;     // Lookups refFilter answered as absent; guarded by reservationsMutex
+uint64_t refFilterFalsePositives = 0; // Lookups it let through that found nothing; guarded by reservationsMutex
+
+// Rebuilds refFilter from allReservations and the cold archive; caller must hold reservationsMutex (or be loading)
+void rebuildRefFilter(uint32_t bitsPerKey) {
+    refFilter.reset(2 * (allReservations.size() + coldArchive.reservationCount()), bitsPerKey);
+    for (const auto& res : allReservations) refFilter.add(res.referenceNumber);
+    coldArchive.forEach([](const Reservation& res) { refFilter.add(res.referenceNumber); });
+    refFilterChanged = true;
+}
+
+// Adds a reference number to refFilter, rebuilding it twice as large once it is full; caller must hold reservationsMutex
+void addToRefFilter(RefKey refNum) {
+    if (refFilter.add(refNum)) refFilterChanged = true;
+    if (refFilter.keyCount() > refFilter.capacity()) rebuildRefFilter(refFilter.bitsPerKey());
+}
+
+// Adds allReservations[slot] to the bitmap indexes; caller must hold reservationsMutex (or be loading)
+void addToFlightBitmaps(size_t slot) {
+    destinationBitmaps.add(allReservations[slot].destination, slot);
+    departureBitmaps.add(allReservations[slot].departureTime, slot);
+}
+
+// Rebuilds the bitmap indexes from allReservations; caller must hold reservationsMutex (or be loading)
+void rebuildFlightBitmaps() {
+    destinationBitmaps.clear();
+    departureBitmaps.clear();
+    for (size_t slot = 0; slot < allReservations.size(); ++slot) addToFlightBitmaps(slot);
+}
+
+// Rebuilds nameTrigramIndex from allReservations; caller must hold reservationsMutex (or be loading)
+void rebuildNameTrigramIndex() {
+    nameTrigramIndex.clear();
+    for (const auto& res : allReservations) nameTrigramIndex.addReservation(res);
+}
+
+// Rebuilds referenceKeys from allReservations; caller must hold reservationsMutex (or be loading)
+void rebuildReferenceKeys() {
+    referenceKeys.clear();
+    referenceKeys.reserve(allReservations.size());
+    for (const auto& res : allReservations) referenceKeys.push_back(res.referenceNumber.value);
+}
+
+// A save appends a delta unless this would leave too much of the file in deltas
+const size_t MAX_DELTA_SEGMENTS = 32;       // Rewrite in full after this many deltas
+const double MAX_DELTA_FRACTION = 0.25;     // ...or once deltas hold this fraction of the full image
+
+/**
+ * @brief Marks a reservation slot as added or changed since the last save.
+ * Caller must hold reservationsMutex.
+ * @param slot Index into allReservations.
+ */
+void markDirty(size_t slot) {
+    if (dirtyFlags.size() <= slot) dirtyFlags.resize(max(slot + 1, dirtyFlags.size() * 2), 0);
+    if (dirtyFlags[slot]) return;
+    dirtyFlags[slot] = 1;
+    dirtySlots.push_back(slot);
+}
+
+// Rebuilds every index over allReservations (not the reference filter); caller must hold reservationsMutex (or be loading)
+void rebuildStoreIndexes() {
+    refHashIndex.build(allReservations);
+    refSortedIndex.build(allReservations);
+    rebuildReferenceKeys();
+    eytzingerStale = true;
+    passengerNameIndex.build(allReservations);
+    rebuildNameTrigramIndex();
+    rebuildFlightBitmaps();
+    seatMaps.build(allReservations);
+}
+
+/**
+ * @brief Loads the reservation store at startup: the latest snapshot followed by the booking log.
+ * Installations that predate the binary snapshot only have the text file, which is read instead.
+ * Snapshot reservations are loaded per STORE_LOAD_MODE, so passengers are decoded on demand.
+ * @param readOnly True for batch jobs running beside the interactive program: no file is renamed,
+ *        rebuilt or truncated, and the booking log is not opened for appends.
+ * @return False if the snapshot, the booking log or the archive exists but could not be read, so
+ *         reservations may be missing (the interactive program carries on without them).
+ */
+bool loadStore(bool readOnly = false) {
+    bool readable = true;
+    if (isBinarySnapshot(SNAPSHOT_FILE)) {
+        string error;
+        snapshotExists = readSnapshot(SNAPSHOT_FILE, allReservations, snapshotState, error, STORE_LOAD_MODE);
+        readable = snapshotExists;
+        if (!snapshotExists && readOnly) {
+            cerr << "Error: Could not load " << SNAPSHOT_FILE << ": " << error << "\n";
+        } else if (!snapshotExists) {
+            // Keep the unreadable file (e.g. an older format version) instead of overwriting it at the next save
+            string keptFilename = SNAPSHOT_FILE + ".unreadable";
+            cerr << "Error: Could not load " << SNAPSHOT_FILE << ": " << error << "\n";
+            if (replaceFile(SNAPSHOT_FILE, keptFilename)) cerr << "It has been kept as " << keptFilename << ".\n";
+        } else if (!readOnly && !refIndexIsCurrent(SNAPSHOT_FILE, REF_INDEX_FILE)) {
+            rebuildRefIndex(SNAPSHOT_FILE, REF_INDEX_FILE);
+        }
+    } else {
+        allReservations = loadReservations(TEXT_FILE);
+    }
+    size_t persisted = snapshotExists ? allReservations.size() : 0;
+    uint64_t validBytes;
+    appliedLogSequence = replayBookingLog(WAL_FILE, snapshotState.walSequence, allReservations, validBytes);
+    error_code ec;
+    uintmax_t logBytes = filesystem::file_size(WAL_FILE, ec);
+    if (validBytes == 0 && !ec && logBytes > WAL_FILE_HEADER_SIZE) readable = false; // Not a log this version can read
+    if (!readOnly) bookingLog.open(WAL_FILE, validBytes, appliedLogSequence);
+    for (size_t slot = persisted; slot < allReservations.size(); ++slot) markDirty(slot);
+    rebuildStoreIndexes();
+    if (!coldArchive.open(ARCHIVE_FILE)) readable = false;
+    if (refFilter.load(REF_FILTER_FILE, currentRefFilterCoverage())) {
+        for (size_t slot = persisted; slot < allReservations.size(); ++slot) addToRefFilter(allReservations[slot].referenceNumber);
+    } else {
+        RefFilterView stale; // Keep the sizing the user chose
+        rebuildRefFilter(stale.open(REF_FILTER_FILE) ? stale.getHeader().bitsPerKey : refFilter.bitsPerKey());
+    }
+    return readable;
+}
+
+/**
+ * @brief Records a new booking: logs it durably, then adds it to allReservations.
+ * The wait for the log happens without holding any store lock, so concurrent bookings share a
+ * group commit batch. Batches become durable in sequence order, and bookings are applied in that
+ * same order, so appliedLogSequence never skips a booking.
+ * @param res The new reservation.
+ * @return False if the booking could not be logged; it is then not added either.
+ */
+bool addReservation(const Reservation& res) {
+    uint64_t sequence = bookingLog.append(res);
+    if (sequence == 0) return false;
+    unique_lock<mutex> bookingLock(bookingMutex);
+    bookingApplied.wait(bookingLock, [sequence] { return appliedLogSequence + 1 >= sequence; });
+    {
+        lock_guard<mutex> lock(reservationsMutex);
+        allReservations.push_back(res);
+        markDirty(allReservations.size() - 1);
+        refHashIndex.insert(allReservations, allReservations.size() - 1);
+        refSortedIndex.insert(allReservations, allReservations.size() - 1);
+        referenceKeys.push_back(res.referenceNumber.value);
+        eytzingerStale = true;
+        passengerNameIndex.insert(allReservations, allReservations.size() - 1);
+        nameTrigramIndex.addReservation(res);
+        addToFlightBitmaps(allReservations.size() - 1);
+        seatMaps.insert(allReservations, allReservations.size() - 1);
+        addToRefFilter(res.referenceNumber);
+        appliedLogSequence = sequence;
+    }
+    bookingApplied.notify_all();
+    return true;
+}
+
+/**
+ * @brief Adds many reservations at once (e.g. an import) without logging each one.
+ * Callers are expected to checkpoint afterwards so the new reservations become durable.
+ * @param reservations The reservations to add.
+ */
+void addReservationsUnlogged(const vector<Reservation>& reservations) {
+    lock_guard<mutex> bookingLock(bookingMutex);
+    lock_guard<mutex> lock(reservationsMutex);
+    allReservations.insert(allReservations.end(), reservations.begin(), reservations.end());
+    refHashIndex.reserve(allReservations.size());
+    for (size_t slot = allReservations.size() - reservations.size(); slot < allReservations.size(); ++slot) {
+        markDirty(slot);
+        refHashIndex.insert(allReservations, slot);
+        referenceKeys.push_back(allReservations[slot].referenceNumber.value);
+        addToFlightBitmaps(slot);
+        seatMaps.insert(allReservations, slot);
+        addToRefFilter(allReservations[slot].referenceNumber);
+    }
+    refSortedIndex.insertRange(allReservations, allReservations.size() - reservations.size());
+    passengerNameIndex.insertRange(allReservations, allReservations.size() - reservations.size());
+    for (const auto& res : reservations) nameTrigramIndex.addReservation(res);
+    eytzingerStale = true;
+}
+
+/**
+ * @brief Finds an active reservation by reference number through the hash index.
+ * @param refNum The reference number.
+ * @return Its slot in allReservations, or -1 if it is not active (it may be archived).
+ */
+int findReservationSlot(RefKey refNum) {
+    lock_guard<mutex> lock(reservationsMutex);
+    return refHashIndex.find(refNum);
+}
+
+/**
+ * @brief Asks the reference filter whether a reference number can exist, active or archived.
+ * @param refNum The reference number.
+ * @return False if it definitely does not, so there is nothing to search.
+ */
+bool referenceMayExist(RefKey refNum) {
+    lock_guard<mutex> lock(reservationsMutex);
+    if (refFilter.mightContain(refNum)) return true;
+    ++refFilterRejections;
+    return false;
+}
+
+// Records that a reference number the filter let through turned out not to exist
+void noteRefFilterFalsePositive() {
+    lock_guard<mutex> lock(reservationsMutex);
+    ++refFilterFalsePositives;
+}
+
+// Snapshot of the reference filter's sizing and hit counters
+struct RefFilterStats {
+    size_t keys = 0;
+    size_t capacity = 0;
+    uint32_t bitsPerKey = 0;
+    uint32_t hashCount = 0;
+    size_t memoryBytes = 0;
+    double estimatedFalsePositiveRate = 0; // From the bits set
+    uint64_t rejections = 0;               // Lookups answered as absent by the filter alone
+    uint64_t falsePositives = 0;           // Lookups it let through that found nothing
+
+    // Share of lookups for missing references that the filter failed to stop
+    double observedFalsePositiveRate() const {
+        uint64_t misses = rejections + falsePositives;
+        return misses == 0 ? 0.0 : static_cast<double>(falsePositives) / misses;
+    }
+};
+
+RefFilterStats getRefFilterStats() {
+    lock_guard<mutex> lock(reservationsMutex);
+    RefFilterStats stats;
+    stats.keys = refFilter.keyCount();
+    stats.capacity = refFilter.capacity();
+    stats.bitsPerKey = refFilter.bitsPerKey();
+    stats.hashCount = refFilter.hashCount();
+    stats.memoryBytes = refFilter.memoryBytes();
+    stats.estimatedFalsePositiveRate = refFilter.estimatedFalsePositiveRate();
+    stats.rejections = refFilterRejections;
+    stats.falsePositives = refFilterFalsePositives;
+    return stats;
+}
+
+/**
+ * @brief Rebuilds the reference filter with a new size; it is saved at the next checkpoint.
+ * @param bitsPerKey Filter bits per reference number.
+ */
+void resizeRefFilter(uint32_t bitsPerKey) {
+    lock_guard<mutex> lock(reservationsMutex);
+    rebuildRefFilter(bitsPerKey);
+    refFilterRejections = 0;
+    refFilterFalsePositives = 0;
+}
+
+/**
+ * @brief Finds an active reservation by reference number through the sorted index (binary search).
+ * @param refNum The reference number.
+ * @return Its slot in allReservations, or -1 if it is not active (it may be archived).
+ */
+int findReservationSlotSorted(RefKey refNum) {
+    lock_guard<mutex> lock(reservationsMutex);
+    return refSortedIndex.find(refNum);
+}
+
+/**
+ * @brief Finds many active reservations at once (e.g. a reconciliation run).
+ * The whole batch is probed under one lock through the hash index, with the buckets of upcoming
+ * references prefetched so their cache misses overlap.
+ * @param refs The reference numbers, in any order and possibly repeated.
+ * @return For each reference number in input order, its slot in allReservations or -1 if it is not
+ *         active (it may be archived).
+ */
+vector<int> findReservationSlots(const vector<RefKey>& refs) {
+    vector<int> slots(refs.size());
+    lock_guard<mutex> lock(reservationsMutex);
+    refHashIndex.findBatch(refs.data(), refs.size(), slots.data());
+    return slots;
+}
+
+/**
+ * @brief Finds an active reservation by reference number through the Eytzinger-layout index.
+ * The index is rebuilt (O(n), from the sorted index) on the first lookup after a change.
+ * @param refNum The reference number.
+ * @return Its slot in allReservations, or -1 if it is not active (it may be archived).
+ */
+int findReservationSlotEytzinger(RefKey refNum) {
+    lock_guard<mutex> lock(reservationsMutex);
+    if (eytzingerStale) {
+        refEytzingerIndex.build(refSortedIndex, allReservations);
+        eytzingerStale = false;
+    }
+    return refEytzingerIndex.find(refNum);
+}
+
+/**
+ * @brief Finds an active reservation by reference number with a vectorized scan of referenceKeys.
+ * @param refNum The reference number.
+ * @return Its slot in allReservations (the first if it occurs more than once), or -1.
+ */
+int scanReservationSlot(RefKey refNum) {
+    lock_guard<mutex> lock(reservationsMutex);
+    size_t slot = scanKeys(referenceKeys.data(), referenceKeys.size(), refNum.value);
+    return slot < referenceKeys.size() ? static_cast<int>(slot) : -1;
+}
+
+/**
+ * @brief Finds active bookings by passenger name through the name index.
+ * @param name The passenger name (case and extra spaces are ignored).
+ * @param prefix True to match every name starting with name.
+ * @param limit At most this many matches are returned.
+ * @return The matching (slot, passenger) pairs in name order.
+ */
+vector<PassengerMatch> findPassengersByName(const string& name, bool prefix, size_t limit) {
+    lock_guard<mutex> lock(reservationsMutex);
+    return passengerNameIndex.find(name, prefix, limit);
+}
+
+/**
+ * @brief Finds the passenger names closest to a possibly misspelled one.
+ * @param name The name as typed.
+ * @param maxDistance Largest edit distance accepted.
+ * @param limit At most this many names are returned.
+ * @return The names, closest first; look their bookings up with findPassengersByName().
+ */
+vector<FuzzyNameMatch> findPassengerNamesFuzzy(const string& name, int maxDistance, size_t limit) {
+    lock_guard<mutex> lock(reservationsMutex);
+    return nameTrigramIndex.search(name, maxDistance, limit);
+}
+
+/**
+ * @brief Finds who is booked in a seat on a flight through the seat maps.
+ * @param flightDate The flight date as YYYY-MM-DD.
+ * @param destination The destination, as stored (e.g. LONDON).
+ * @param departureTime The departure time, as stored (e.g. 8.00AM).
+ * @param seat The seat number.
+ * @return The (slot, passenger) pairs holding the seat; more than one means it was double booked.
+ */
+vector<PassengerMatch> findSeatHolders(const string& flightDate, const string& destination, const string& departureTime, int seat) {
+    lock_guard<mutex> lock(reservationsMutex);
+    return seatMaps.holders(flightKey(flightDate, destination, departureTime), seat);
+}
+
+/**
+ * @brief Copies the seat map of a flight, for a cabin manifest.
+ * @param flightDate The flight date as YYYY-MM-DD.
+ * @param destination The destination, as stored.
+ * @param departureTime The departure time, as stored.
+ * @param seats Receives the flight's seats.
+ * @return False if nobody is booked on the flight.
+ */
+bool findFlightSeats(const string& flightDate, const string& destination, const string& departureTime, FlightSeats& seats) {
+    lock_guard<mutex> lock(reservationsMutex);
+    const FlightSeats* flight = seatMaps.find(flightKey(flightDate, destination, departureTime));
+    if (!flight) return false;
+    seats = *flight;
+    return true;
+}
+
+// Slots matching the destination and departure time lists (empty = any); caller must hold reservationsMutex
+vector<size_t> flightBitmapSlots(const vector<string>& destinations, const vector<string>& departureTimes) {
+    vector<size_t> slots;
+    auto collect = [&slots](uint32_t slot) { slots.push_back(slot); };
+    if (destinations.empty() && departureTimes.empty()) {
+        for (size_t slot = 0; slot < allReservations.size(); ++slot) slots.push_back(slot);
+    } else if (departureTimes.empty()) {
+        destinationBitmaps.anyOf(destinations).forEach(collect);
+    } else if (destinations.empty()) {
+        departureBitmaps.anyOf(departureTimes).forEach(collect);
+    } else {
+        CompressedBitmap::intersect(destinationBitmaps.anyOf(destinations), departureBitmaps.anyOf(departureTimes)).forEach(collect);
+    }
+    return slots;
+}
+
+/**
+ * @brief Finds active reservations by destination and departure time through the bitmap indexes.
+ * Within a field the values are OR-ed, and the two fields are AND-ed.
+ * @param destinations Accepted destinations (empty = any).
+ * @param departureTimes Accepted departure times (empty = any).
+ * @return The matching slots of allReservations, in increasing order.
+ */
+vector<size_t> findReservationsByFlight(const vector<string>& destinations, const vector<string>& departureTimes) {
+    lock_guard<mutex> lock(reservationsMutex);
+    return flightBitmapSlots(destinations, departureTimes);
+}
+
+/**
+ * @brief Answers a compiled query over the active reservations.
+ * Accepted destinations and departure times are looked up in the bitmap indexes first, and only
+ * the reservations they leave are scanned; other queries scan every reservation in parallel.
+ * @param query The compiled query.
+ * @param scanned Receives how many reservations had to be tested.
+ * @return The matching slots of allReservations, in increasing order.
+ */
+vector<size_t> runReservationQuery(const CompiledQuery& query, size_t& scanned) {
+    lock_guard<mutex> lock(reservationsMutex);
+    scanned = 0;
+    if (query.never) return {};
+    if (!query.destination.restricted && !query.departureTime.restricted) {
+        scanned = allReservations.size();
+        return executeQuery(query, allReservations, nullptr);
+    }
+    vector<size_t> candidates = flightBitmapSlots(query.destination.restricted ? query.destination.allowed : vector<string>(),
+                                                  query.departureTime.restricted ? query.departureTime.allowed : vector<string>());
+    scanned = candidates.size();
+    return executeQuery(query, allReservations, &candidates);
+}
+
+/**
+ * @brief Lists the active reservations whose reference numbers fall in a range, in order.
+ * @param first Smallest reference number to include.
+ * @param last Largest reference number to include.
+ * @return Their slots in allReservations.
+ */
+vector<size_t> reservationSlotsInRange(RefKey first, RefKey last) {
+    lock_guard<mutex> lock(reservationsMutex);
+    vector<size_t> slots;
+    refSortedIndex.forEachInRange(first, last, [&slots](size_t slot) { slots.push_back(slot); });
+    return slots;
+}
+
+/**
+ * @brief Saves the store and compacts the booking log.
+ * Only reservations added or changed since the last save are written, as a delta segment appended
+ * to the snapshot, so the cost follows the number of changes rather than the size of
+ * allReservations. Every MAX_DELTA_SEGMENTS saves, or once deltas reach MAX_DELTA_FRACTION of the
+ * full image, the snapshot is rewritten in full instead.
+ * The slots to save and the log sequence they correspond to are captured together; the
+ * reservations are then copied a chunk at a time and written without holding any lock, so
+ * bookings keep flowing while the save is on its way, even for a full rewrite.
+ * The snapshot remembers that sequence, so a crash between writing it and compacting the log
+ * is harmless: replay skips records the snapshot already has.
+ * Each save also extends (or, after a full rewrite, rebuilds) the reference index and rewrites
+ * the reference filter.
+ * @return True if both the save and the compaction succeeded.
+ */
+bool checkpointReservations() {
+    static mutex checkpointMutex; // One checkpoint at a time (background, import and exit)
+    lock_guard<mutex> checkpointLock(checkpointMutex);
+
+    vector<Reservation> toWrite;
+    vector<uint64_t> slots;
+    vector<size_t> savedSlots;
+    uint64_t throughSequence;
+    size_t totalReservations;
+    bool fullRewrite;
+    bool forcedRewrite;
+    RefBloomFilter filterToSave;
+    bool saveFilter;
+    {
+        lock_guard<mutex> lock(reservationsMutex);
+        throughSequence = appliedLogSequence;
+        totalReservations = allReservations.size();
+        forcedRewrite = forceFullSnapshot;
+        forceFullSnapshot = false;
+        fullRewrite = forcedRewrite || !snapshotExists || snapshotState.damaged || snapshotState.deltaSegments >= MAX_DELTA_SEGMENTS ||
+                      snapshotState.deltaRecords + dirtySlots.size() > MAX_DELTA_FRACTION * max<size_t>(snapshotState.fullRecords, 1);
+        if (!fullRewrite) {
+            // Empty if nothing is new since the last save; the log then only holds records the snapshot already has
+            sort(dirtySlots.begin(), dirtySlots.end());
+            slots.assign(dirtySlots.begin(), dirtySlots.end());
+        }
+        saveFilter = refFilterChanged || fullRewrite || !dirtySlots.empty();
+        if (saveFilter) filterToSave = refFilter;
+        refFilterChanged = false;
+        for (size_t slot : dirtySlots) dirtyFlags[slot] = 0;
+        savedSlots.swap(dirtySlots);
+    }
+
+    // Slots below totalReservations stay put while bookings are added, unless archiving renumbers
+    // them; it forces a full rewrite when it does, which it then runs itself
+    const size_t COPY_CHUNK = 4096;
+    size_t copyCount = fullRewrite ? totalReservations : slots.size();
+    bool renumbered = false;
+    toWrite.reserve(copyCount);
+    for (size_t first = 0; first < copyCount && !renumbered; first += COPY_CHUNK) {
+        lock_guard<mutex> lock(reservationsMutex);
+        renumbered = forceFullSnapshot;
+        for (size_t i = first; i < min(copyCount, first + COPY_CHUNK) && !renumbered; ++i) {
+            toWrite.push_back(allReservations[fullRewrite ? i : slots[i]]);
+        }
+    }
+    if (renumbered) {
+        lock_guard<mutex> lock(reservationsMutex);
+        if (saveFilter) refFilterChanged = true;
+        return false;
+    }
+
+    bool ok = true;
+    if (fullRewrite) {
+        // A rewrite can keep the snapshot's shape while changing its keys; drop the old filter first
+        // so a crash before the new one is saved leaves none rather than a stale one
+        error_code ec;
+        filesystem::remove(REF_FILTER_FILE, ec);
+        ok = writeSnapshot(toWrite, SNAPSHOT_FILE, throughSequence);
+        if (ok) {
+            snapshotExists = true;
+            snapshotState = SnapshotInfo();
+            snapshotState.fullRecords = totalReservations;
+            snapshotState.validBytes = filesystem::file_size(SNAPSHOT_FILE, ec);
+            updateRefIndex(SNAPSHOT_FILE, REF_INDEX_FILE, 0);
+        }
+    } else if (!toWrite.empty()) {
+        uint64_t segmentBytes;
+        ok = appendSnapshotDelta(toWrite, slots, SNAPSHOT_FILE, throughSequence, snapshotState.validBytes, segmentBytes);
+        if (ok) {
+            updateRefIndex(SNAPSHOT_FILE, REF_INDEX_FILE, snapshotState.validBytes);
+            snapshotState.validBytes += segmentBytes;
+            snapshotState.deltaRecords += toWrite.size();
+            ++snapshotState.deltaSegments;
+        }
+    }
+    if (!ok) {
+        lock_guard<mutex> lock(reservationsMutex);
+        for (size_t slot : savedSlots) markDirty(slot); // Try again next time
+        if (forcedRewrite) forceFullSnapshot = true;
+        if (saveFilter) refFilterChanged = true;
+        return false;
+    }
+    // The filter may hold newer bookings too; a filter only has to include what the files hold
+    if (saveFilter && !filterToSave.save(REF_FILTER_FILE, currentRefFilterCoverage())) {
+        lock_guard<mutex> lock(reservationsMutex);
+        refFilterChanged = true;
+    }
+    snapshotState.walSequence = throughSequence;
+    return bookingLog.compact(throughSequence);
+}
+
+/**
+ * @brief When the background checkpointer folds the booking log into a new snapshot.
+ * A checkpoint runs once the log reaches maxLogBytes, or once maxInterval has passed
+ * since the last checkpoint and the log holds at least one booking.
+ */
+struct CheckpointSettings {
+    uint64_t maxLogBytes = 1 << 20;     // Log size trigger (1 MB)
+    chrono::seconds maxInterval{ 300 }; // Elapsed time trigger
+};
+
+struct CheckpointStats {
+    uint64_t checkpoints = 0;        // Completed background checkpoints
+    uint64_t failures = 0;           // Checkpoints that could not be written
+    double lastDurationSeconds = 0.0;
+    string lastTrigger = "none";     // "log size" or "elapsed time"
+};
+
+/**
+ * @brief Background thread that periodically checkpoints the reservation store.
+ * Booking and menu code never waits for it; it only briefly takes reservationsMutex
+ * to capture a point-in-time copy of the reservations.
+ */
+class Checkpointer {
+public:
+    ~Checkpointer() { stop(); }
+
+    void start() {
+        stop();
+        lock_guard<mutex> lock(stateMutex);
+        stopping = false;
+        lastCheckpoint = chrono::steady_clock::now();
+        worker = thread(&Checkpointer::run, this);
+    }
+
+    void stop() {
+        {
+            lock_guard<mutex> lock(stateMutex);
+            stopping = true;
+        }
+        wakeUp.notify_all();
+        if (worker.joinable()) worker.join();
+    }
+
+    CheckpointSettings getSettings() {
+        lock_guard<mutex> lock(stateMutex);
+        return settings;
+    }
+
+    void setSettings(const CheckpointSettings& newSettings) {
+        lock_guard<mutex> lock(stateMutex);
+        settings = newSettings;
+        wakeUp.notify_all();
+    }
+
+    CheckpointStats getStats() {
+        lock_guard<mutex> lock(stateMutex);
+        return stats;
+    }
+
+private:
+    void run() {
+        unique_lock<mutex> lock(stateMutex);
+        while (!stopping) {
+            wakeUp.wait_for(lock, chrono::seconds(1), [&] { return stopping; });
+            if (stopping) break;
+
+            uint64_t logBytes = bookingLog.sizeBytes();
+            string trigger;
+            if (logBytes >= settings.maxLogBytes) {
+                trigger = "log size";
+            } else if (logBytes > WAL_FILE_HEADER_SIZE && chrono::steady_clock::now() - lastCheckpoint >= settings.maxInterval) {
+                trigger = "elapsed time";
+            } else {
+                continue;
+            }
+
+            lock.unlock();
+            auto start = chrono::steady_clock::now();
+            bool ok = checkpointReservations();
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            lock.lock();
+
+            lastCheckpoint = chrono::steady_clock::now();
+            if (ok) ++stats.checkpoints;
+            else ++stats.failures;
+            stats.lastDurationSeconds = seconds;
+            stats.lastTrigger = trigger;
+        }
+    }
+
+    mutex stateMutex;              // Guards the members below
+    condition_variable wakeUp;
+    bool stopping = false;
+    CheckpointSettings settings;
+    CheckpointStats stats;
+    chrono::steady_clock::time_point lastCheckpoint;
+    thread worker;
+};
+
+Checkpointer checkpointer; // Keeps the booking log short while the program runs
+
+/**
+ * @brief Moves reservations for flights that have already departed into the cold archive.
+ * The reservations are appended to the archive and synced first, then removed from
+ * allReservations, and the snapshot is rewritten in full because the remaining slots are
+ * renumbered. A crash in between leaves them in both tiers; they are skipped here next time.
+ * @return Number of reservations moved.
+ */
+size_t archiveDepartedFlights() {
+    string today = todayDate();
+    auto departed = [&today](const Reservation& res) { return !res.flightDate.empty() && res.flightDate < today; };
+
+    lock_guard<mutex> bookingLock(bookingMutex); // No bookings while slots are renumbered
+    vector<Reservation> moving;
+    {
+        lock_guard<mutex> lock(reservationsMutex);
+        for (const auto& res : allReservations) {
+            if (departed(res)) moving.push_back(res);
+        }
+    }
+    if (moving.empty()) return 0;
+
+    vector<Reservation> toArchive;
+    Reservation existing;
+    for (auto& res : moving) {
+        if (!coldArchive.find(res.referenceNumber, existing)) toArchive.push_back(move(res));
+    }
+    if (!toArchive.empty()) {
+        if (!ColdArchive::append(ARCHIVE_FILE, move(toArchive), coldArchive.validBytes())) return 0;
+        coldArchive.open(ARCHIVE_FILE);
+    }
+
+    {
+        lock_guard<mutex> lock(reservationsMutex);
+        allReservations.erase(remove_if(allReservations.begin(), allReservations.end(), departed), allReservations.end());
+        rebuildStoreIndexes();
+        dirtySlots.clear();
+        dirtyFlags.assign(dirtyFlags.size(), 0);
+        forceFullSnapshot = true;
+    }
+    checkpointReservations();
+    return moving.size();
+}
+
+// --- Sorting Algorithms ---
+
+/**
+ * @brief Sorts a vector of reservations using Bubble Sort.
+ * Compares adjacent elements and swaps them if they are in the wrong order.
+ * Sorts by totalPrice in ascending order.
+ * @param arr The vector of Reservation objects to sort.
+ */
+void bubbleSort(vector<Reservation>& arr) {
+    int n = arr.size();
+    for (int i = 0; i < n - 1; ++i) {
+        for (int j = 0; j < n - i - 1; ++j) {
+            // Compare based on totalPrice
+            if (arr[j].totalPrice > arr[j+1].totalPrice) {
+                // Swap if the current element is greater than the next
+                swap(arr[j], arr[j+1]);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Merges two sorted sub-arrays into one.
+ * Helper function for Merge Sort.
+ * @param arr The main array containing the sub-arrays.
+ * @param l The starting index of the first sub-array.
+ * @param m The ending index of the first sub-array.
+ * @param r The ending index of the second sub-array.
+ */
+void merge(vector<Reservation>& arr, int l, int m, int r) {
+    int n1 = m - l + 1; // Size of left sub-array
+    int n2 = r - m;     // Size of right sub-array
+
+    // Create temporary arrays
+    vector<Reservation> L(n1);
+    vector<Reservation> R(n2);
+
+    // Copy data to temporary arrays
+    for (int i = 0; i < n1; ++i)
+        L[i] = arr[l + i];
+    for (int j = 0; j < n2; ++j)
+        R[j] = arr[m + 1 + j];
+
+    // Merge the temporary arrays back into arr[l..r]
+    int i = 0; // Initial index of first sub-array
+    int j = 0; // Initial index of second sub-array
+    int k = l; // Initial index of merged sub-array
+
+    while (i < n1 && j < n2) {
+        // Compare based on totalPrice
+        if (L[i].totalPrice <= R[j].totalPrice) {
+            arr[k] = L[i];
+            i++;
+        } else {
+            arr[k] = R[j];
+            j++;
+        }
+        k++;
+    }
+
+    // Copy remaining elements of L[], if any
+    while (i < n1) {
+        arr[k] = L[i];
+        i++;
+        k++;
+    }
+
+    // Copy remaining elements of R[], if any
+    while (j < n2) {
+        arr[k] = R[j];
+        j++;
+        k++;
+    }
+}
+
+/**
+ * @brief Sorts a vector of reservations using Merge Sort.
+ * A recursive, divide-and-conquer sorting algorithm.
+ * Sorts by totalPrice in ascending order.
+ * @param arr The vector of Reservation objects to sort.
+ * @param l The starting index of the sub-array to sort.
+ * @param r The ending index of the sub-array to sort.
+ */
+void mergeSort(vector<Reservation>& arr, int l, int r) {
+    if (l < r) {
+        int m = l + (r - l) / 2; // Find the middle point
+        mergeSort(arr, l, m);    // Sort first half
+        mergeSort(arr, m + 1, r); // Sort second half
+        merge(arr, l, m, r);     // Merge the sorted halves
+    }
+}
+
+// Wrapper for mergeSort to be called easily
+void mergeSort(vector<Reservation>& arr) {
+    if (!arr.empty()) {
+        mergeSort(arr, 0, arr.size() - 1);
+    }
+}
+
+// --- Searching Algorithms ---
+
+/**
+ * @brief Searches for a reservation by reference number using Linear Search.
+ * Checks each element sequentially until a match is found.
+ * @param arr The vector of Reservation objects to search.
+ * @param refNum The reference number to search for.
+ * @return The index of the found reservation, or -1 if not found.
+ */
+int linearSearch(const vector<Reservation>& arr, RefKey refNum) {
+    for (int i = 0; i < arr.size(); ++i) {
+        if (arr[i].referenceNumber == refNum) {
+            return i; // Found at index i
+        }
     }
     return -1; // Not found
 }
@@ -705,7 +5957,7 @@ int linearSearch(const vector<Reservation>& arr, const string& refNum) {
  * @param refNum The reference number to search for.
  * @return The index of the found reservation, or -1 if not found.
  */
-int binarySearch(const vector<Reservation>& arr, const string& refNum) {
+int binarySearch(const vector<Reservation>& arr, RefKey refNum) {
     int low = 0;
     int high = arr.size() - 1;
 
@@ -723,25 +5975,935 @@ int binarySearch(const vector<Reservation>& arr, const string& refNum) {
     return -1; // Not found
 }
 
-// --- Report Generation and DSA Integration ---
+// --- Synthetic Data (for benchmarks) ---
+
+const char* const DESTINATIONS[] = { "JAKARTA", "BANGKOK", "MAKKAH", "TOKYO", "PARIS", "LONDON", "CHICAGO" };
+const char* const DEPARTURE_TIMES[] = { "8.00AM", "1.30PM", "5.00PM", "10.30PM" };
+const char* const FIRST_NAMES[] = { "Ahmad", "Siti", "John", "Mei", "Aisyah", "Kenji", "Maria", "Omar", "Priya", "Liam",
+                                    "Nurul", "Chen", "Fatimah", "David", "Yuki", "Hassan", "Sofia", "Arjun", "Emma", "Faris" };
+const char* const LAST_NAMES[] = { "Ismail", "Tan", "Smith", "Wong", "Rahman", "Tanaka", "Garcia", "Ali", "Kumar", "Brown",
+                                   "Hassan", "Lee", "Abdullah", "Jones", "Sato", "Ibrahim", "Rossi", "Patel", "Wilson", "Mustapha" };
 
 /**
- * @brief Generates and displays a report of all reservations.
- * Includes options for sorting and searching demonstration.
+ * @brief Generates a reference number in the same "RB" + 6 characters form as generateReferenceNumber().
+ * @param rng The random generator to draw from (keeps benchmarks reproducible).
  */
-void generateReport() {
+RefKey randomReferenceNumber(mt19937& rng) {
+    static const char alphanumeric[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    string refNum = "RB";
+    for (int i = 0; i < 6; ++i) {
+        refNum += alphanumeric[rng() % (sizeof(alphanumeric) - 1)];
+    }
+    RefKey key;
+    RefKey::fromString(refNum, key);
+    return key;
+}
+
+/**
+ * @brief Generates a passenger name from a corpus of a few million distinct names.
+ * The surnames are built from syllables, so they are varied enough for name index benchmarks.
+ * @param rng The random generator to draw from.
+ */
+string syntheticPassengerName(mt19937& rng) {
+    static const char* const syllables[] = { "AB", "DUL", "RAH", "MAN", "TAN", "LEE", "KU", "MAR", "SA", "TO",
+                                             "NA", "KA", "RI", "WI", "SON", "BER", "HAS", "SAN", "LI", "NG" };
+    string name = string(FIRST_NAMES[rng() % 20]) + " ";
+    int count = 2 + static_cast<int>(rng() % 3);
+    for (int i = 0; i < count; ++i) name += syllables[rng() % 20];
+    return name;
+}
+
+/**
+ * @brief Builds a plausible random reservation with 1-4 passengers.
+ * @param rng The random generator to draw from.
+ */
+Reservation makeSyntheticReservation(mt19937& rng) {
+    Reservation res;
+    res.referenceNumber = randomReferenceNumber(rng);
+    res.destination = DESTINATIONS[rng() % 7];
+    res.departureTime = DEPARTURE_TIMES[rng() % 4];
+    static const int firstYear = stoi(todayDate().substr(0, 4)) - 2; // Dates span two years back to a year ahead
+    char date[11];
+    snprintf(date, sizeof(date), "%04d-%02d-%02d", firstYear + static_cast<int>(rng() % 4), 1 + static_cast<int>(rng() % 12),
+             1 + static_cast<int>(rng() % 28));
+    res.flightDate = date;
+    int numPassengers = 1 + rng() % 4;
+    for (int i = 0; i < numPassengers; ++i) {
+        Passenger p;
+        p.name = string(FIRST_NAMES[rng() % 20]) + " " + LAST_NAMES[rng() % 20];
+        p.age = 2 + rng() % 70;
+        p.seatNumber = 1 + rng() % 81;
+        p.travelClass = (p.seatNumber <= 15) ? "Business Class" : "Economy Class";
+        res.passengers.push_back(p);
+        if (p.age >= 18) res.numAdults++;
+        else res.numKids++;
+        res.totalPrice += (p.age >= 18 ? 1000.0 : 500.0) + (p.seatNumber <= 15 ? 500.0 : 0.0);
+    }
+    if (rng() % 4 == 0) {
+        res.discountApplied = res.totalPrice * 0.10;
+        res.totalPrice -= res.discountApplied;
+    }
+    return res;
+}
+
+// --- Performance Benchmarks ---
+
+/**
+ * @brief Measures booking throughput through the group-commit log with several concurrent writers.
+ * Uses a scratch log file and the current group-commit settings.
+ */
+void benchmarkGroupCommit() {
+    const string benchFile = "wal_benchmark.tmp";
+    const int bookingsPerThread = 200;
+    const int threadCounts[] = { 1, 4, 16 };
+    GroupCommitSettings settings = bookingLog.getSettings();
+
+    // Books from threadCount threads at once; returns the elapsed seconds
+    auto bookConcurrently = [bookingsPerThread](int threadCount, const auto& book) {
+        auto start = chrono::high_resolution_clock::now();
+        vector<thread> workers;
+        for (int t = 0; t < threadCount; ++t) {
+            workers.emplace_back([&book, t, bookingsPerThread]() {
+                mt19937 rng(t + 1);
+                for (int i = 0; i < bookingsPerThread; ++i) book(makeSyntheticReservation(rng));
+            });
+        }
+        for (auto& worker : workers) worker.join();
+        return chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+    };
+    auto printRow = [](const char* path, int threadCount, const GroupCommitStats& stats, double seconds) {
+        cout << "  " << left << setw(16) << path << right << setw(7) << threadCount
+             << "   " << setw(10) << fixed << setprecision(0) << stats.records / seconds
+             << "   " << setw(9) << setprecision(2) << stats.averageBatchSize()
+             << "   " << setw(7) << stats.largestBatch
+             << "   " << setw(14) << setprecision(3) << stats.averageCommitSeconds() * 1000.0
+             << "   " << setw(13) << stats.averageWaitSeconds() * 1000.0 << "\n";
+    };
+
+    cout << "\nGroup commit benchmark (window " << settings.window.count() << " us, max batch "
+         << settings.maxBatchRecords << ", " << bookingsPerThread << " bookings per thread)\n";
+    cout << "\n  Path              Threads   Bookings/s   Avg batch   Largest   Avg fsync (ms)   Avg wait (ms)\n";
+    for (int threadCount : threadCounts) {
+        BookingLog log;
+        remove(benchFile.c_str());
+        if (!log.open(benchFile, 0, 0)) return;
+        log.setSettings(settings);
+        double seconds = bookConcurrently(threadCount, [&log](const Reservation& res) { log.append(res); });
+        GroupCommitStats stats = log.getStats();
+        log.close();
+        printRow("log append", threadCount, stats, seconds);
+    }
+
+    // The same bookings through addReservation(), which also applies them to the store and its
+    // indexes. The live store is checkpointed and set aside meanwhile, so none of them reach it.
+    checkpointer.stop();
+    checkpointReservations();
+    uint64_t liveSequence = bookingLog.lastSequence();
+    GroupCommitStats liveStats = bookingLog.exchangeStats();
+    bookingLog.close();
+    vector<Reservation> liveReservations;
+    vector<size_t> liveDirtySlots;
+    vector<uint8_t> liveDirtyFlags;
+    uint64_t liveApplied;
+    {
+        lock_guard<mutex> bookingLock(bookingMutex);
+        lock_guard<mutex> lock(reservationsMutex);
+        liveReservations.swap(allReservations);
+        liveDirtySlots.swap(dirtySlots);
+        liveDirtyFlags.swap(dirtyFlags);
+        liveApplied = appliedLogSequence;
+    }
+    for (int threadCount : threadCounts) {
+        {
+            lock_guard<mutex> bookingLock(bookingMutex);
+            lock_guard<mutex> lock(reservationsMutex);
+            allReservations.clear();
+            dirtySlots.clear();
+            dirtyFlags.clear();
+            appliedLogSequence = 0;
+            rebuildStoreIndexes();
+        }
+        remove(benchFile.c_str());
+        if (!bookingLog.open(benchFile, 0, 0)) break;
+        bookingLog.setSettings(settings);
+        double seconds = bookConcurrently(threadCount, [](const Reservation& res) { addReservation(res); });
+        bookingLog.close();
+        printRow("addReservation", threadCount, bookingLog.exchangeStats(), seconds);
+    }
+    remove(benchFile.c_str());
+
+    {
+        lock_guard<mutex> bookingLock(bookingMutex);
+        lock_guard<mutex> lock(reservationsMutex);
+        allReservations.swap(liveReservations);
+        dirtySlots.swap(liveDirtySlots);
+        dirtyFlags.swap(liveDirtyFlags);
+        appliedLogSequence = liveApplied;
+        rebuildStoreIndexes();
+        rebuildRefFilter(refFilter.bitsPerKey()); // Drop the synthetic reference numbers
+    }
+    error_code ec;
+    uint64_t liveLogBytes = filesystem::file_size(WAL_FILE, ec);
+    bookingLog.open(WAL_FILE, ec ? 0 : liveLogBytes, liveSequence);
+    bookingLog.setSettings(settings);
+    bookingLog.exchangeStats(liveStats);
+    checkpointer.start();
+}
+
+/**
+ * @brief Asks how many synthetic records a benchmark should use.
+ * @param what Description of the records (e.g. "reservations").
+ * @param defaultCount Used when the answer is not a positive number.
+ */
+size_t askBenchmarkSize(const string& what, size_t defaultCount) {
+    cout << "\nNumber of synthetic " << what << " to generate (0 = " << defaultCount << "):\n";
+    long long count;
+    cin >> count;
+    if (cin.fail()) {
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        count = 0;
+    }
+    return count > 0 ? static_cast<size_t>(count) : defaultCount;
+}
+
+/**
+ * @brief Measures text-format load throughput (MB/s and records/s) as the parser thread count grows.
+ */
+void benchmarkParallelLoad() {
+    const string benchFile = "load_benchmark.tmp";
+    size_t count = askBenchmarkSize("reservations", 200000);
+
+    mt19937 rng(42);
+    vector<Reservation> reservations;
+    reservations.reserve(count);
+    for (size_t i = 0; i < count; ++i) reservations.push_back(makeSyntheticReservation(rng));
+    saveReservations(reservations, benchFile, StorageFormat::Text);
+    reservations.clear();
+    reservations.shrink_to_fit();
+
+    error_code ec;
+    double megabytes = filesystem::file_size(benchFile, ec) / (1024.0 * 1024.0);
+    unsigned maxThreads = max(8u, thread::hardware_concurrency());
+    cout << "\nParallel text loader benchmark (" << count << " reservations, " << fixed << setprecision(1)
+         << megabytes << " MB, " << thread::hardware_concurrency() << " hardware threads)\n";
+    cout << "\n  Threads   Seconds      MB/s      Records/s\n";
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+        auto start = chrono::high_resolution_clock::now();
+        vector<Reservation> loaded = loadTextReservations(benchFile, threads);
+        chrono::duration<double> duration = chrono::high_resolution_clock::now() - start;
+        cout << "  " << setw(7) << threads
+             << "   " << setw(7) << setprecision(3) << duration.count()
+             << "   " << setw(7) << setprecision(1) << megabytes / duration.count()
+             << "   " << setw(12) << setprecision(0) << loaded.size() / duration.count() << "\n";
+    }
+    remove(benchFile.c_str());
+}
+
+/**
+ * @brief Measures CRC32C throughput of the hardware and software implementations.
+ * Record verification on load runs at this speed.
+ */
+void benchmarkChecksums() {
+    const size_t bufferBytes = 64 * 1024 * 1024;
+    const int rounds = 4;
+    string buffer(bufferBytes, '\0');
+    mt19937 rng(7);
+    for (auto& c : buffer) c = static_cast<char>(rng());
+
+    cout << "\nCRC32C throughput over " << bufferBytes / (1024 * 1024) << " MB x " << rounds << " rounds\n";
+    auto measure = [&](const string& name, uint32_t (*implementation)(uint32_t, const char*, size_t)) {
+        uint32_t crc = 0;
+        auto start = chrono::high_resolution_clock::now();
+        for (int r = 0; r < rounds; ++r) crc += implementation(crc, buffer.data(), buffer.size());
+        chrono::duration<double> duration = chrono::high_resolution_clock::now() - start;
+        cout << "  " << left << setw(10) << name << right << fixed << setprecision(2)
+             << setw(8) << (static_cast<double>(bufferBytes) * rounds / (1024.0 * 1024.0 * 1024.0)) / duration.count()
+             << " GB/s   (crc " << hex << crc << dec << ")\n";
+    };
+    measure("Software", crc32cSoftware);
+#ifdef HAVE_HARDWARE_CRC32C
+    if (hardwareCrc32cAvailable()) measure("Hardware", crc32cHardware);
+    else cout << "  Hardware  not supported by this CPU\n";
+#else
+    cout << "  Hardware  not available on this platform\n";
+#endif
+}
+
+/**
+ * @brief Measures the key scan kernels (scalar, SSE4.2, AVX2) against linearSearch.
+ * Every lookup misses, so each one scans the whole array; throughput is keys compared per nanosecond.
+ */
+void benchmarkKeyScan() {
+    const size_t sizes[] = { 1000, 100000, 10000000 };
+    mt19937 rng(11);
+    cout << "\nReference key scan throughput (keys per nanosecond, every lookup scans the whole array)\n";
+    cout << "\n        Keys  linearSearch    Scalar    SSE4.2      AVX2\n";
+    size_t found = 0;
+    for (size_t n : sizes) {
+        vector<uint64_t> keys(n);
+        for (auto& key : keys) key = randomReferenceNumber(rng).value;
+        size_t lookups = max<size_t>(3, 100000000 / n);
+
+        cout << "  " << setw(10) << n << fixed << setprecision(2);
+        if (n <= 100000) { // Reservations are large, so the baseline is only built for the smaller sizes
+            vector<Reservation> reservations(n);
+            for (size_t i = 0; i < n; ++i) reservations[i].referenceNumber = RefKey(keys[i]);
+            auto start = chrono::high_resolution_clock::now();
+            for (size_t i = 0; i < lookups; ++i) found += linearSearch(reservations, RefKey(i)) != -1; // Small keys never match "RB..."
+            chrono::duration<double, nano> time = chrono::high_resolution_clock::now() - start;
+            cout << "  " << setw(12) << static_cast<double>(n) * lookups / time.count();
+        } else {
+            cout << "  " << setw(12) << "-";
+        }
+        for (KeyScanKernel kernel : { KeyScanKernel::Scalar, KeyScanKernel::Sse42, KeyScanKernel::Avx2 }) {
+            if (!keyScanKernelSupported(kernel)) {
+                cout << "  " << setw(8) << "n/a";
+                continue;
+            }
+            auto start = chrono::high_resolution_clock::now();
+            for (size_t i = 0; i < lookups; ++i) found += scanKeys(keys.data(), n, i, kernel) != n;
+            chrono::duration<double, nano> time = chrono::high_resolution_clock::now() - start;
+            cout << "  " << setw(8) << static_cast<double>(n) * lookups / time.count();
+        }
+        cout << "\n";
+    }
+    cout << "\nRuntime dispatch picks the " << keyScanKernelName(bestKeyScanKernel()) << " kernel on this CPU"
+         << (found == 0 ? "." : " (unexpected match!).") << "\n";
+}
+
+/**
+ * @brief Times the passenger name index against a full scan on a synthetic name corpus.
+ */
+void benchmarkNameIndex() {
+    const size_t reservationCount = 1000000;
+    const size_t lookups = 10000;
+    const size_t limit = 100;
+    mt19937 rng(31);
+    vector<Reservation> reservations;
+    reservations.reserve(reservationCount);
+    size_t passengerCount = 0;
+    for (size_t i = 0; i < reservationCount; ++i) {
+        reservations.push_back(makeSyntheticReservation(rng));
+        for (auto& p : reservations.back().passengers) p.name = syntheticPassengerName(rng);
+        passengerCount += reservations.back().passengers.size();
+    }
+    vector<string> names(lookups);
+    for (auto& name : names) {
+        const Reservation& res = reservations[rng() % reservationCount];
+        name = res.passengers[rng() % res.passengers.size()].name;
+    }
+
+    cout << "\nPassenger name index over " << reservationCount << " reservations (" << passengerCount << " passengers)\n";
+    PassengerNameIndex index;
+    auto start = chrono::high_resolution_clock::now();
+    index.build(reservations);
+    chrono::duration<double, milli> buildTime = chrono::high_resolution_clock::now() - start;
+    cout << "\n  Build                    " << fixed << setprecision(1) << setw(10) << buildTime.count() << " ms\n";
+
+    size_t matches = 0;
+    start = chrono::high_resolution_clock::now();
+    for (const auto& name : names) matches += index.find(name, false, limit).size();
+    chrono::duration<double, micro> exactTime = chrono::high_resolution_clock::now() - start;
+    cout << "  Exact lookup             " << setw(10) << setprecision(2) << exactTime.count() / lookups << " us   ("
+         << setprecision(1) << static_cast<double>(matches) / lookups << " matches on average)\n";
+
+    matches = 0;
+    start = chrono::high_resolution_clock::now();
+    for (const auto& name : names) matches += index.find(string_view(name).substr(0, name.find(' ') + 3), true, limit).size();
+    chrono::duration<double, micro> prefixTime = chrono::high_resolution_clock::now() - start;
+    cout << "  Prefix lookup (limit " << limit << ") " << setw(10) << setprecision(2) << prefixTime.count() / lookups << " us   ("
+         << setprecision(1) << static_cast<double>(matches) / lookups << " matches on average)\n";
+
+    matches = 0;
+    string wanted = normalizePassengerName(names[0]);
+    start = chrono::high_resolution_clock::now();
+    for (const auto& res : reservations) {
+        for (const auto& p : res.passengers) matches += normalizePassengerName(p.name) == wanted;
+    }
+    chrono::duration<double, micro> scanTime = chrono::high_resolution_clock::now() - start;
+    cout << "  Full scan (one name)     " << setw(10) << setprecision(2) << scanTime.count() << " us   (" << matches << " matches)\n";
+}
+
+/**
+ * @brief Times typo-tolerant name search on a synthetic corpus against comparing every name.
+ * Queries are indexed names with one or two random edits; recall counts how often the original
+ * name is among the results.
+ */
+void benchmarkFuzzyNameSearch() {
+    const size_t corpusSize = 1000000;
+    const size_t queryCount = 1000;
+    const size_t bruteForceQueries = 20;
+    const int maxDistance = 2;
+    mt19937 rng(47);
+    vector<string> corpus(corpusSize);
+    for (auto& name : corpus) name = normalizePassengerName(syntheticPassengerName(rng));
+
+    NameTrigramIndex index;
+    auto start = chrono::high_resolution_clock::now();
+    for (const auto& name : corpus) index.add(name);
+    chrono::duration<double, milli> buildTime = chrono::high_resolution_clock::now() - start;
+
+    // Misspells a name with 1-2 substitutions, insertions or deletions
+    vector<string> originals(queryCount), queries(queryCount);
+    for (size_t i = 0; i < queryCount; ++i) {
+        originals[i] = corpus[rng() % corpusSize];
+        string typo = originals[i];
+        int edits = 1 + static_cast<int>(rng() % maxDistance);
+        for (int e = 0; e < edits && typo.size() > 1; ++e) {
+            size_t at = rng() % typo.size();
+            char letter = static_cast<char>('A' + rng() % 26);
+            switch (rng() % 3) {
+                case 0: typo[at] = letter; break;
+                case 1: typo.insert(typo.begin() + at, letter); break;
+                default: typo.erase(at, 1); break;
+            }
+        }
+        queries[i] = typo;
+    }
+
+    cout << "\nFuzzy passenger name search over " << index.size() << " distinct names (at most " << maxDistance << " edits)\n";
+    cout << "\n  Trigram index build        " << fixed << setprecision(1) << setw(10) << buildTime.count() << " ms\n";
+    size_t recalled = 0, results = 0;
+    start = chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < queryCount; ++i) {
+        vector<FuzzyNameMatch> found = index.search(queries[i], maxDistance, 10);
+        results += found.size();
+        for (const auto& match : found) recalled += match.name == originals[i];
+    }
+    chrono::duration<double, micro> indexTime = chrono::high_resolution_clock::now() - start;
+    cout << "  Trigram search             " << setw(10) << setprecision(1) << indexTime.count() / queryCount << " us   (recall "
+         << setprecision(1) << 100.0 * recalled / queryCount << "%, " << static_cast<double>(results) / queryCount
+         << " names per query)\n";
+
+    size_t bruteMatches = 0;
+    start = chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < bruteForceQueries; ++i) {
+        for (const auto& name : corpus) bruteMatches += editDistance(queries[i], name, maxDistance) <= maxDistance;
+    }
+    chrono::duration<double, micro> bruteTime = chrono::high_resolution_clock::now() - start;
+    cout << "  Edit distance to every name" << setw(10) << setprecision(1) << bruteTime.count() / bruteForceQueries << " us   ("
+         << bruteMatches << " matches over " << bruteForceQueries << " queries)\n";
+}
+
+/**
+ * @brief Compares binarySearch with the sorted key array and the Eytzinger layout as data outgrows the cache.
+ * binarySearch walks Reservation objects, so it is only run while they fit in about 1 GB. The key
+ * arrays grow (up to 10^8 keys, about 2.3 GB of memory) until they are well beyond the last-level cache.
+ */
+void benchmarkSearchLayouts() {
+    const size_t lookups = 1000000;
+    size_t cacheBytes = lastLevelCacheBytes();
+    mt19937 rng(23);
+    cout << "\nSearch layout benchmark (nanoseconds per lookup, all lookups hit)\n";
+    if (cacheBytes != 0) cout << "Last-level cache: " << cacheBytes / 1024 << " KB\n";
+    cout << "\n        Keys  Keys (MB)  binarySearch     Sorted  Eytzinger  + prefetch\n";
+    size_t found = 0, attempted = 0;
+    for (size_t n = 10000; n <= 100000000; n *= 10) {
+        vector<uint64_t> keys(n);
+        for (auto& key : keys) key = randomReferenceNumber(rng).value;
+        vector<uint64_t> queries(lookups);
+        for (auto& query : queries) query = keys[rng() % n];
+        sort(keys.begin(), keys.end());
+        keys.erase(unique(keys.begin(), keys.end()), keys.end());
+        vector<uint64_t> slots(keys.size());
+        for (size_t i = 0; i < slots.size(); ++i) slots[i] = i;
+        RefEytzingerIndex eytzinger;
+        eytzinger.build(keys, slots);
+
+        auto time = [&](auto lookup) {
+            auto start = chrono::high_resolution_clock::now();
+            for (uint64_t query : queries) found += lookup(RefKey(query)) != -1;
+            attempted += queries.size();
+            chrono::duration<double, nano> elapsed = chrono::high_resolution_clock::now() - start;
+            return elapsed.count() / queries.size();
+        };
+        double keyMegabytes = keys.size() * sizeof(uint64_t) / (1024.0 * 1024.0);
+        cout << "  " << setw(10) << n << fixed << setprecision(1) << "  " << setw(9) << keyMegabytes
+             << (cacheBytes != 0 && keys.size() * sizeof(uint64_t) > cacheBytes ? "*" : " ") << setprecision(0);
+        if (n * sizeof(Reservation) <= (size_t(1) << 30)) {
+            vector<Reservation> reservations(keys.size());
+            for (size_t i = 0; i < keys.size(); ++i) reservations[i].referenceNumber = RefKey(keys[i]);
+            cout << "  " << setw(12) << time([&](RefKey key) { return binarySearch(reservations, key); });
+        } else {
+            cout << "  " << setw(12) << "-";
+        }
+        cout << "  " << setw(9) << time([&](RefKey key) {
+                    auto hit = lower_bound(keys.begin(), keys.end(), key.value);
+                    return hit != keys.end() && *hit == key.value ? static_cast<int>(hit - keys.begin()) : -1;
+                })
+             << "  " << setw(9) << time([&](RefKey key) { return eytzinger.find(key, false); })
+             << "  " << setw(10) << time([&](RefKey key) { return eytzinger.find(key, true); }) << "\n";
+        if (cacheBytes != 0 && keys.size() * sizeof(uint64_t) > 2 * cacheBytes) break; // Far enough past the cache
+    }
+    if (cacheBytes != 0) cout << "\n* Keys alone exceed the last-level cache.\n";
+    cout << found << " of " << attempted << " lookups found their reservation.\n";
+}
+
+/**
+ * @brief Compares reference number lookups: linearSearch, the SIMD key scan, binarySearch and the hash index.
+ * The synthetic reservations carry only a reference number, so 10^7 of them fit in memory.
+ * binarySearch is timed on data that is already sorted; the sort itself is not counted.
+ */
+void benchmarkRefLookup() {
+    cout << "\nLargest size as a power of ten (3-7, 0 = 6; 10^7 needs about 2.5 GB of memory):\n";
+    int maxExponent;
+    cin >> maxExponent;
+    if (cin.fail() || maxExponent < 3 || maxExponent > 7) {
+        cin.clear();
+        maxExponent = 6;
+    }
+
+    const size_t lookups = 100000;
+    mt19937 rng(42);
+    vector<Reservation> reservations;
+    size_t found = 0, attempted = 0;
+    cout << "\nReference number lookup benchmark (nanoseconds per lookup, all lookups hit)\n";
+    cout << "\n  Reservations    Linear  SIMD scan     Binary       Hash   Hash build (ms)\n";
+    size_t n = 1;
+    for (int exponent = 1; exponent <= maxExponent; ++exponent) {
+        n *= 10;
+        if (exponent < 3) continue;
+        reservations.reserve(n);
+        while (reservations.size() < n) {
+            Reservation res;
+            res.referenceNumber = randomReferenceNumber(rng);
+            reservations.push_back(move(res));
+        }
+        vector<RefKey> queries(1000);
+        for (auto& query : queries) query = reservations[rng() % n].referenceNumber;
+
+        // A linear scan is O(n), so fewer lookups are timed as n grows
+        size_t linearLookups = min<size_t>(queries.size(), max<size_t>(10, 10000000 / n));
+        auto start = chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < linearLookups; ++i) found += linearSearch(reservations, queries[i]) != -1;
+        chrono::duration<double, nano> linearTime = chrono::high_resolution_clock::now() - start;
+        attempted += linearLookups;
+
+        vector<uint64_t> keys;
+        keys.reserve(n);
+        for (const auto& res : reservations) keys.push_back(res.referenceNumber.value);
+        start = chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < linearLookups; ++i) found += scanKeys(keys.data(), keys.size(), queries[i].value) != keys.size();
+        chrono::duration<double, nano> scanTime = chrono::high_resolution_clock::now() - start;
+        attempted += linearLookups;
+        vector<uint64_t>().swap(keys);
+
+        sort(reservations.begin(), reservations.end(), [](const Reservation& a, const Reservation& b) {
+            return a.referenceNumber < b.referenceNumber;
+        });
+        start = chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < lookups; ++i) found += binarySearch(reservations, queries[i % queries.size()]) != -1;
+        chrono::duration<double, nano> binaryTime = chrono::high_resolution_clock::now() - start;
+        attempted += lookups;
+
+        RefHashIndex index;
+        start = chrono::high_resolution_clock::now();
+        index.build(reservations);
+        chrono::duration<double, milli> buildTime = chrono::high_resolution_clock::now() - start;
+        start = chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < lookups; ++i) found += index.find(queries[i % queries.size()]) != -1;
+        chrono::duration<double, nano> hashTime = chrono::high_resolution_clock::now() - start;
+        attempted += lookups;
+
+        cout << "  " << setw(12) << n << fixed << setprecision(0)
+             << "  " << setw(9) << linearTime.count() / linearLookups
+             << "  " << setw(9) << scanTime.count() / linearLookups
+             << "  " << setw(9) << binaryTime.count() / lookups
+             << "  " << setw(9) << hashTime.count() / lookups
+             << "  " << setw(16) << setprecision(1) << buildTime.count() << "\n";
+    }
+    cout << "\n" << found << " of " << attempted << " lookups found their reservation.\n";
+}
+
+/**
+ * @brief Times destination/departure-time queries through bitmap indexes against a full scan.
+ * Each query ORs one to three destinations and ANDs the result with one departure time.
+ */
+void benchmarkFlightBitmaps() {
+    const size_t reservationCount = 2000000;
+    const size_t queryCount = 200;
+    mt19937 rng(53);
+    vector<Reservation> reservations;
+    reservations.reserve(reservationCount);
+    for (size_t i = 0; i < reservationCount; ++i) reservations.push_back(makeSyntheticReservation(rng));
+
+    BitmapIndex destinations, departures;
+    auto start = chrono::high_resolution_clock::now();
+    for (size_t slot = 0; slot < reservations.size(); ++slot) {
+        destinations.add(reservations[slot].destination, slot);
+        departures.add(reservations[slot].departureTime, slot);
+    }
+    chrono::duration<double, milli> buildTime = chrono::high_resolution_clock::now() - start;
+
+    vector<pair<vector<string>, string>> queries(queryCount);
+    for (auto& query : queries) {
+        size_t wanted = 1 + rng() % 3;
+        while (query.first.size() < wanted) {
+            string destination = DESTINATIONS[rng() % 7];
+            if (find(query.first.begin(), query.first.end(), destination) == query.first.end()) query.first.push_back(destination);
+        }
+        query.second = DEPARTURE_TIMES[rng() % 4];
+    }
+
+    size_t bitmapMatches = 0;
+    start = chrono::high_resolution_clock::now();
+    for (const auto& query : queries) {
+        CompressedBitmap::intersect(destinations.anyOf(query.first), departures.anyOf({ query.second }))
+            .forEach([&bitmapMatches](uint32_t) { ++bitmapMatches; });
+    }
+    chrono::duration<double, milli> bitmapTime = chrono::high_resolution_clock::now() - start;
+
+    size_t scanMatches = 0;
+    start = chrono::high_resolution_clock::now();
+    for (const auto& query : queries) {
+        for (const auto& res : reservations) {
+            scanMatches += res.departureTime == query.second &&
+                           find(query.first.begin(), query.first.end(), res.destination) != query.first.end();
+        }
+    }
+    chrono::duration<double, milli> scanTime = chrono::high_resolution_clock::now() - start;
+
+    cout << "\nFlight bitmap indexes over " << reservationCount << " reservations\n";
+    cout << "\n  Build                    " << fixed << setprecision(1) << setw(10) << buildTime.count() << " ms   ("
+         << (destinations.memoryBytes() + departures.memoryBytes()) / 1024 << " KB)\n";
+    cout << "  Bitmap AND/OR query      " << setw(10) << setprecision(2) << bitmapTime.count() / queryCount << " ms   ("
+         << bitmapMatches / queryCount << " matches on average)\n";
+    cout << "  Full scan query          " << setw(10) << scanTime.count() / queryCount << " ms\n";
+    cout << "\n" << (bitmapMatches == scanMatches ? "Both methods returned the same reservations." : "Result counts differ!") << "\n";
+}
+
+/**
+ * @brief Measures what the reference filter saves on lookups for reference numbers that do not exist.
+ * For several sizes the filter is built over a million reference numbers and probed with a million
+ * that were never issued; the rate that gets through is compared with the estimate the filter reports.
+ */
+void benchmarkRefFilter() {
+    const size_t keyCount = 1000000;
+    const size_t probeCount = 1000000;
+    const size_t scanMisses = 20;
+    mt19937 rng(61);
+    vector<Reservation> reservations(keyCount);
+    vector<uint64_t> issued(keyCount);
+    for (size_t i = 0; i < keyCount; ++i) {
+        reservations[i].referenceNumber = randomReferenceNumber(rng);
+        issued[i] = reservations[i].referenceNumber.value;
+    }
+    sort(issued.begin(), issued.end());
+    vector<RefKey> unknown;
+    unknown.reserve(probeCount);
+    while (unknown.size() < probeCount) {
+        RefKey key = randomReferenceNumber(rng);
+        if (!binary_search(issued.begin(), issued.end(), key.value)) unknown.push_back(key);
+    }
+
+    RefHashIndex hashIndex;
+    hashIndex.build(reservations);
+    int slot = 0;
+    auto start = chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < scanMisses; ++i) slot += linearSearch(reservations, unknown[i]);
+    chrono::duration<double, micro> scanTime = chrono::high_resolution_clock::now() - start;
+    start = chrono::high_resolution_clock::now();
+    for (const auto& key : unknown) slot += hashIndex.find(key);
+    chrono::duration<double, nano> hashTime = chrono::high_resolution_clock::now() - start;
+
+    cout << "\nLookups for unknown reference numbers among " << keyCount << " reservations\n";
+    cout << "\n  Linear search miss       " << fixed << setprecision(1) << setw(10) << scanTime.count() / scanMisses << " us";
+    cout << "\n  Hash index miss          " << setw(10) << hashTime.count() / probeCount << " ns\n";
+    cout << "\n  Bits/key  Probes  Size (KB)  Probe (ns)  Estimated FPR  Measured FPR\n";
+    for (uint32_t bitsPerKey : { 4u, 6u, 8u, 10u, 12u, 16u }) {
+        RefBloomFilter filter;
+        filter.reset(keyCount, bitsPerKey);
+        for (const auto& res : reservations) filter.add(res.referenceNumber);
+        size_t passed = 0;
+        start = chrono::high_resolution_clock::now();
+        for (const auto& key : unknown) passed += filter.mightContain(key);
+        chrono::duration<double, nano> probeTime = chrono::high_resolution_clock::now() - start;
+        cout << "  " << setw(8) << bitsPerKey << "  " << setw(6) << filter.hashCount() << "  " << setw(9) << filter.memoryBytes() / 1024
+             << "  " << setw(10) << setprecision(1) << probeTime.count() / probeCount
+             << "  " << setw(12) << setprecision(3) << filter.estimatedFalsePositiveRate() * 100.0 << " %"
+             << "  " << setw(10) << static_cast<double>(passed) / probeCount * 100.0 << " %\n";
+    }
+    cout << (slot == -static_cast<int>(scanMisses + probeCount) ? "" : "\nUnexpected match!\n");
+}
+
+/**
+ * @brief Times batch reference lookups against the same lookups made one at a time.
+ * Batches mix references that exist with ones that do not, in random order.
+ */
+void benchmarkBatchLookup() {
+    size_t n = askBenchmarkSize("reservations", 4000000);
+    const size_t linearLookups = 10;
+    mt19937 rng(67);
+    vector<Reservation> reservations(n);
+    for (auto& res : reservations) res.referenceNumber = randomReferenceNumber(rng);
+    RefHashIndex hashIndex;
+    RefSortedIndex sortedIndex;
+    hashIndex.build(reservations);
+    sortedIndex.build(reservations);
+
+    int checksum = 0;
+    auto start = chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < linearLookups; ++i) checksum += linearSearch(reservations, reservations[rng() % n].referenceNumber);
+    chrono::duration<double, nano> linearTime = chrono::high_resolution_clock::now() - start;
+
+    cout << "\nBatch reference lookup over " << n << " reservations (nanoseconds per reference)\n";
+    cout << "\nOne linearSearch per reference: " << fixed << setprecision(0) << linearTime.count() / linearLookups << " ns\n";
+    cout << "\n    Batch   Single hash   Hash batch   Single binary\n";
+    for (size_t batch = 1000; batch <= min<size_t>(n, 10000000); batch *= 10) {
+        vector<RefKey> refs(batch);
+        for (auto& ref : refs) ref = rng() % 4 != 0 ? reservations[rng() % n].referenceNumber : randomReferenceNumber(rng);
+        vector<int> single(batch), hashed(batch);
+        size_t rounds = max<size_t>(1, 1000000 / batch);
+
+        start = chrono::high_resolution_clock::now();
+        for (size_t r = 0; r < rounds; ++r) {
+            for (size_t i = 0; i < batch; ++i) single[i] = hashIndex.find(refs[i]);
+        }
+        chrono::duration<double, nano> singleTime = chrono::high_resolution_clock::now() - start;
+        start = chrono::high_resolution_clock::now();
+        for (size_t r = 0; r < rounds; ++r) hashIndex.findBatch(refs.data(), batch, hashed.data());
+        chrono::duration<double, nano> hashTime = chrono::high_resolution_clock::now() - start;
+        start = chrono::high_resolution_clock::now();
+        for (size_t r = 0; r < rounds; ++r) {
+            for (size_t i = 0; i < batch; ++i) checksum += sortedIndex.find(refs[i]);
+        }
+        chrono::duration<double, nano> binaryTime = chrono::high_resolution_clock::now() - start;
+
+        double lookups = static_cast<double>(batch) * rounds;
+        cout << "  " << setw(7) << batch << "  " << setw(12) << setprecision(1) << singleTime.count() / lookups
+             << "  " << setw(11) << hashTime.count() / lookups << "  " << setw(14) << binaryTime.count() / lookups
+             << (single == hashed ? "" : "  (results differ!)")
+             << "\n";
+    }
+    if (checksum == 1) cout << "\n"; // Keeps the timed lookups from being optimized away
+}
+
+/**
+ * @brief Times compiled filter queries on synthetic reservations: narrowed by the bitmap indexes,
+ * and as full scans on one thread and on every hardware thread.
+ */
+void benchmarkQueries() {
+    const size_t reservationCount = 2000000;
+    const char* const queries[] = {
+        "price > 3000 and destination = LONDON and kids >= 1",
+        "destination in (PARIS, TOKYO) and time = 8.00AM and adults >= 2",
+        "age < 12 and class = business",
+        "date >= 2026-01-01 and date < 2026-07-01 and discount > 0",
+    };
+    mt19937 rng(71);
+    vector<Reservation> reservations;
+    reservations.reserve(reservationCount);
+    BitmapIndex destinations, departures;
+    for (size_t slot = 0; slot < reservationCount; ++slot) {
+        reservations.push_back(makeSyntheticReservation(rng));
+        destinations.add(reservations[slot].destination, slot);
+        departures.add(reservations[slot].departureTime, slot);
+    }
+    unsigned threads = max(1u, thread::hardware_concurrency());
+
+    cout << "\nCompiled queries over " << reservationCount << " reservations (milliseconds)\n";
+    cout << "\n  Matches   Indexed   Scan (1 thread)   Scan (" << threads << " threads)   Query\n";
+    for (const char* text : queries) {
+        CompiledQuery query;
+        string error;
+        if (!compileQuery(text, query, error)) {
+            cout << "  " << text << ": " << error << "\n";
+            continue;
+        }
+        auto timed = [](auto run) {
+            auto start = chrono::high_resolution_clock::now();
+            vector<size_t> slots = run();
+            chrono::duration<double, milli> time = chrono::high_resolution_clock::now() - start;
+            return make_pair(slots, time.count());
+        };
+        auto single = timed([&]() { return executeQuery(query, reservations, nullptr, 1); });
+        auto parallel = timed([&]() { return executeQuery(query, reservations, nullptr, threads); });
+        string indexedTime = "-";
+        bool same = single.first == parallel.first;
+        if (query.destination.restricted || query.departureTime.restricted) {
+            auto indexed = timed([&]() {
+                CompressedBitmap narrowed = query.destination.restricted ? destinations.anyOf(query.destination.allowed) : CompressedBitmap();
+                if (query.departureTime.restricted) {
+                    CompressedBitmap times = departures.anyOf(query.departureTime.allowed);
+                    narrowed = query.destination.restricted ? CompressedBitmap::intersect(narrowed, times) : times;
+                }
+                vector<size_t> candidates;
+                narrowed.forEach([&candidates](uint32_t slot) { candidates.push_back(slot); });
+                return executeQuery(query, reservations, &candidates, threads);
+            });
+            same = same && indexed.first == single.first;
+            ostringstream formatted;
+            formatted << fixed << setprecision(1) << indexed.second;
+            indexedTime = formatted.str();
+        }
+        cout << "  " << setw(7) << single.first.size() << "  " << setw(8) << indexedTime << "  " << setw(16) << fixed
+             << setprecision(1) << single.second << "  " << setw(11 + to_string(threads).size()) << parallel.second << "   " << text
+             << (same ? "" : "  (results differ!)") << "\n";
+    }
+}
+
+/**
+ * @brief Compares answering "who is in seat N on this flight" through the seat maps with walking
+ * every reservation and passenger, which is what the question cost before the maps existed.
+ */
+void benchmarkSeatMaps() {
+    const size_t reservationCount = 1000000;
+    const size_t mapLookups = 200000;
+    const size_t scanLookups = 20;
+    mt19937 rng(89);
+    vector<Reservation> reservations;
+    reservations.reserve(reservationCount);
+    for (size_t i = 0; i < reservationCount; ++i) reservations.push_back(makeSyntheticReservation(rng));
+
+    SeatMapIndex index;
+    auto start = chrono::high_resolution_clock::now();
+    index.build(reservations);
+    chrono::duration<double, milli> buildTime = chrono::high_resolution_clock::now() - start;
+
+    // Seats on flights that exist, so the lookups do not stop at the hash table
+    vector<pair<string, int>> lookups(mapLookups);
+    vector<size_t> bookedOn(mapLookups); // A reservation on each lookup's flight, for the scan
+    for (size_t i = 0; i < mapLookups; ++i) {
+        auto& lookup = lookups[i];
+        bookedOn[i] = rng() % reservations.size();
+        const Reservation& res = reservations[bookedOn[i]];
+        lookup.first = flightKey(res.flightDate, res.destination, res.departureTime);
+        lookup.second = 1 + static_cast<int>(rng() % SEATS_PER_FLIGHT);
+    }
+
+    size_t mapHolders = 0;
+    start = chrono::high_resolution_clock::now();
+    for (const auto& lookup : lookups) mapHolders += index.holders(lookup.first, lookup.second).size();
+    chrono::duration<double, milli> mapTime = chrono::high_resolution_clock::now() - start;
+
+    size_t manifestSeats = 0;
+    start = chrono::high_resolution_clock::now();
+    for (const auto& lookup : lookups) {
+        const FlightSeats* flight = index.find(lookup.first);
+        for (const auto& occupant : flight->seats) manifestSeats += !occupant.isEmpty();
+    }
+    chrono::duration<double, milli> manifestTime = chrono::high_resolution_clock::now() - start;
+
+    size_t scanHolders = 0, checkedHolders = 0;
+    start = chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < scanLookups; ++i) {
+        const Reservation& flight = reservations[bookedOn[i]];
+        for (const auto& res : reservations) {
+            if (res.flightDate != flight.flightDate || res.destination != flight.destination || res.departureTime != flight.departureTime) continue;
+            for (const auto& p : res.passengers) scanHolders += p.seatNumber == lookups[i].second;
+        }
+    }
+    chrono::duration<double, milli> scanTime = chrono::high_resolution_clock::now() - start;
+    for (size_t i = 0; i < scanLookups; ++i) checkedHolders += index.holders(lookups[i].first, lookups[i].second).size();
+
+    cout << "\nSeat maps over " << reservationCount << " reservations (" << index.flightCount() << " flights, "
+         << index.doubleBookingCount() << " double bookings)\n";
+    cout << "\n  Build                    " << fixed << setprecision(1) << setw(10) << buildTime.count() << " ms   ("
+         << index.memoryBytes() / 1024 << " KB)\n";
+    cout << "  Seat lookup (seat map)   " << setw(10) << setprecision(3) << mapTime.count() * 1000.0 / mapLookups << " us   ("
+         << setprecision(2) << static_cast<double>(mapHolders) / mapLookups << " passengers on average)\n";
+    cout << "  Cabin manifest (seat map)" << setw(10) << setprecision(3) << manifestTime.count() * 1000.0 / mapLookups << " us   ("
+         << setprecision(1) << static_cast<double>(manifestSeats) / mapLookups << " seats taken on average)\n";
+    cout << "  Seat lookup (full scan)  " << setw(10) << setprecision(3) << scanTime.count() * 1000.0 / scanLookups << " us\n";
+    cout << "\n" << (scanHolders == checkedHolders ? "Both methods found the same passengers." : "Results differ!") << "\n";
+}
+
+/**
+ * @brief Menu of performance benchmarks for the storage and search code.
+ */
+void runBenchmarks() {
+    cout << "\n========== P E R F O R M A N C E   B E N C H M A R K S ==========\n";
+    cout << "\n1. Booking log group commit";
+    cout << "\n2. Parallel text loader";
+    cout << "\n3. CRC32C checksum throughput";
+    cout << "\n4. Reference number lookup (linear / SIMD scan / binary / hash index)";
+    cout << "\n5. Reference key scan kernels (scalar / SSE4.2 / AVX2)";
+    cout << "\n6. Binary search layouts (sorted / Eytzinger)";
+    cout << "\n7. Passenger name index";
+    cout << "\n8. Fuzzy passenger name search";
+    cout << "\n9. Destination / departure time bitmap indexes";
+    cout << "\n10. Reference filter on unknown reference numbers";
+    cout << "\n11. Batch reference lookup (hash index with prefetch)";
+    cout << "\n12. Compiled filter queries (indexed / parallel scan)";
+    cout << "\n13. Seat maps (seat lookup / cabin manifest)";
+    cout << "\n14. Back";
+    cout << "\n\nChoose an option:\n";
+
+    int benchChoice;
+    cin >> benchChoice;
+    if (cin.fail()) {
+        cin.clear();
+        benchChoice = 0;
+    }
     clearScreen();
-    int totalTickets = 0;
-    int totalAdults = 0;
-    int totalKids = 0;
+
+    switch (benchChoice) {
+        case 1:
+            benchmarkGroupCommit();
+            break;
+        case 2:
+            benchmarkParallelLoad();
+            break;
+        case 3:
+            benchmarkChecksums();
+            break;
+        case 4:
+            benchmarkRefLookup();
+            break;
+        case 5:
+            benchmarkKeyScan();
+            break;
+        case 6:
+            benchmarkSearchLayouts();
+            break;
+        case 7:
+            benchmarkNameIndex();
+            break;
+        case 8:
+            benchmarkFuzzyNameSearch();
+            break;
+        case 9:
+            benchmarkFlightBitmaps();
+            break;
+        case 10:
+            benchmarkRefFilter();
+            break;
+        case 11:
+            benchmarkBatchLookup();
+            break;
+        case 12:
+            benchmarkQueries();
+            break;
+        case 13:
+            benchmarkSeatMaps();
+            break;
+        case 14:
+            return;
+        default:
+            cout << "\nInvalid option. Please try again.\n";
+            break;
+    }
+}
+
+// --- Report Generation and DSA Integration ---
+
+/**
+ * @brief Report totals, accumulated one reservation at a time in a single pass.
+ */
+struct ReportTotals {
+    long long totalTickets = 0;
+    long long totalAdults = 0;
+    long long totalKids = 0;
     double totalRevenue = 0.0;
     double totalDiscountGiven = 0.0;
+    // Destination-wise reservation counts
+    // Using a map to easily count reservations per destination without fixed variables
+    map<string, long long> destinationTicketCounts;
 
-    // Destination-wise ticket counts
-    // Using a map to easily count tickets per destination without fixed variables
-    map<string, int> destinationTicketCounts;
+    long long archivedReservations = 0; // How many of the reservations came from the cold archive
 
-    for (const auto& res : allReservations) {
+    void add(const Reservation& res) {
         totalTickets += res.passengers.size();
         totalAdults += res.numAdults;
         totalKids += res.numKids;
@@ -749,49 +6911,175 @@ void generateReport() {
         totalDiscountGiven += res.discountApplied;
         destinationTicketCounts[res.destination]++; // Increment count for each destination
     }
+};
 
+/**
+ * @brief Prints the report totals.
+ * @param totals The accumulated totals.
+ */
+void printReportTotals(const ReportTotals& totals) {
     cout << "\n\n========== R A U B   A I R L I N E   R E P O R T ==========";
-    cout << "\n\nTotal Tickets Sold : " << totalTickets;
-    cout << "\nTotal Adults         : " << totalAdults;
-    cout << "\nTotal Kids           : " << totalKids;
+    cout << "\n\nTotal Tickets Sold : " << totals.totalTickets;
+    cout << "\nTotal Adults         : " << totals.totalAdults;
+    cout << "\nTotal Kids           : " << totals.totalKids;
 
     cout << "\n\nTotal tickets sold (by destination):";
-    if (destinationTicketCounts.empty()) {
+    if (totals.destinationTicketCounts.empty()) {
         cout << "\n- No tickets sold yet to any destination.";
     } else {
-        for (const auto& pair : destinationTicketCounts) {
+        for (const auto& pair : totals.destinationTicketCounts) {
             cout << "\n- " << pair.first << " : " << pair.second << " reservations";
         }
     }
 
-    cout << "\n\nTotal Discount Allowed : RM" << fixed << setprecision(2) << totalDiscountGiven;
-    cout << "\nTotal Income           : RM" << fixed << setprecision(2) << totalRevenue;
-    cout << "\nNET PROFIT             : RM" << fixed << setprecision(2) << (totalRevenue + totalDiscountGiven); // Profit is income + discount (since income is after discount)
+    cout << "\n\nTotal Discount Allowed : RM" << fixed << setprecision(2) << totals.totalDiscountGiven;
+    cout << "\nTotal Income           : RM" << fixed << setprecision(2) << totals.totalRevenue;
+    cout << "\nNET PROFIT             : RM" << fixed << setprecision(2) << (totals.totalRevenue + totals.totalDiscountGiven); // Profit is income + discount (since income is after discount)
+    if (totals.archivedReservations > 0) {
+        cout << "\n(Includes " << totals.archivedReservations << " reservations for departed flights from the archive)";
+    }
+}
+
+/**
+ * @brief Report totals of the cold archive.
+ * The archive only grows by appending, so the totals are recomputed only when its size changes.
+ * @return Totals over every archived reservation.
+ */
+const ReportTotals& archiveReportTotals() {
+    static ReportTotals cached;
+    static uint64_t cachedBytes = 0;
+    if (cachedBytes != coldArchive.validBytes()) {
+        cached = ReportTotals();
+        coldArchive.forEach([](const Reservation& res) { cached.add(res); });
+        cached.archivedReservations = coldArchive.reservationCount();
+        cachedBytes = coldArchive.validBytes();
+    }
+    return cached;
+}
+
+/**
+ * @brief Shows a reservation that is not in the active set if the cold archive has it.
+ * @param refNum The reference number searched for.
+ */
+void showArchivedReservation(RefKey refNum) {
+    Reservation archived;
+    if (coldArchive.find(refNum, archived)) {
+        cout << "Reservation found in the archive of departed flights! Details:\n";
+        displayBoardingPass(archived);
+    } else {
+        noteRefFilterFalsePositive(); // Searches only get here past the reference filter
+        cout << "Reservation with Reference Number '" << refNum << "' not found.\n";
+    }
+}
+
+/**
+ * @brief Tells the user when the reference filter rules a reference number out.
+ * @param refNum The reference number searched for.
+ * @return True if the reservation does not exist, so there is nothing to search.
+ */
+bool ruledOutByRefFilter(RefKey refNum) {
+    auto start = chrono::high_resolution_clock::now();
+    bool possible = referenceMayExist(refNum);
+    auto end = chrono::high_resolution_clock::now();
+    if (possible) return false;
+    chrono::duration<double> duration = end - start;
+    cout << "\nReservation with Reference Number '" << refNum << "' not found (ruled out by the reference filter in "
+         << fixed << setprecision(6) << duration.count() << " seconds).\n";
+    return true;
+}
+
+/**
+ * @brief Computes the report straight from a data file with a ReservationCursor.
+ * Memory use does not depend on the size of the file, so multi-year archives can be reported on
+ * without loading them.
+ */
+void streamReport() {
+    string filename;
+    cout << "\nEnter data file to report on (blank = " << SNAPSHOT_FILE << "):\n";
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    getline(cin, filename);
+    string logFilename;
+    bool includeArchive = filename.empty();
+    if (filename.empty()) {
+        filename = SNAPSHOT_FILE;
+        logFilename = WAL_FILE; // Include bookings not yet checkpointed
+    }
+
+    ReservationCursor cursor;
+    string error;
+    if (!cursor.open(filename, logFilename, error)) {
+        cout << "\nCould not read " << filename << ": " << error << "\n";
+        return;
+    }
+    ReportTotals totals;
+    Reservation res;
+    size_t streamed = 0;
+    auto start = chrono::high_resolution_clock::now();
+    while (cursor.next(res)) {
+        totals.add(res);
+        ++streamed;
+    }
+    size_t damagedBlocks = 0;
+    if (includeArchive) {
+        damagedBlocks = coldArchive.forEach([&](const Reservation& archived) {
+            totals.add(archived);
+            ++totals.archivedReservations;
+            ++streamed;
+        });
+    }
+    chrono::duration<double> duration = chrono::high_resolution_clock::now() - start;
+    printReportTotals(totals);
+    cout << "\n\nStreamed " << streamed << " reservations from " << filename << " in " << fixed << setprecision(3)
+         << duration.count() << " seconds.\n";
+    if (cursor.damagedRecords() > 0) {
+        cout << "Warning: " << cursor.damagedRecords() << " damaged records were skipped.\n";
+    }
+    if (damagedBlocks > 0) {
+        cout << "Warning: " << damagedBlocks << " damaged archive blocks were skipped.\n";
+    }
+}
+
+/**
+ * @brief Generates and displays a report of all reservations.
+ * Includes options for sorting and searching demonstration.
+ */
+void generateReport() {
+    clearScreen();
+    ReportTotals totals = archiveReportTotals();
+    for (const auto& res : allReservations) totals.add(res);
+    printReportTotals(totals);
+
     cout << "\n\n--- Data Structures and Algorithms Analysis ---";
     cout << "\n1. Sort Reservations by Total Price (Bubble Sort)";
     cout << "\n2. Sort Reservations by Total Price (Merge Sort)";
     cout << "\n3. Search Reservation by Reference Number (Linear Search)";
     cout << "\n4. Search Reservation by Reference Number (Binary Search)";
-    cout << "\n5. View All Reservations";
-    cout << "\n6. Back to Main Menu";
+    cout << "\n5. Search Reservation by Reference Number (Hash Index)";
+    cout << "\n6. Search Reservation by Reference Number (SIMD Linear Scan)";
+    cout << "\n7. List Reservations by Reference Number Range (Sorted Index)";
+    cout << "\n8. Find Reservations by Destination and Departure Time (Bitmap Index)";
+    cout << "\n9. Query Reservations (e.g. price > 3000 and destination = LONDON and kids >= 1)";
+    cout << "\n10. View All Reservations";
+    cout << "\n11. Performance Benchmarks";
+    cout << "\n12. Report from Saved Data (Streaming)";
+    cout << "\n13. Back to Main Menu";
     cout << "\n\nChoose an option:\n";
 
     int reportChoice;
     cin >> reportChoice;
     clearScreen();
 
-    // Make a copy of reservations for sorting/searching to avoid modifying the original list order if not desired
-    // Or if the original order is needed for other report functions
-    vector<Reservation> tempReservations = allReservations;
-    string searchRefNum;
+    RefKey searchKey;
     int foundIndex;
 
     switch (reportChoice) {
         case 1: { // Bubble Sort
-            if (tempReservations.empty()) {
+            if (allReservations.empty()) {
                 cout << "\nNo reservations to sort.\n";
                 break;
             }
+            // Sort a copy so the original booking order is kept
+            vector<Reservation> tempReservations = allReservations;
             cout << "\nPerforming Bubble Sort on reservations by total price...\n";
             auto start = chrono::high_resolution_clock::now();
             bubbleSort(tempReservations);
@@ -805,10 +7093,12 @@ void generateReport() {
             break;
         }
         case 2: { // Merge Sort
-            if (tempReservations.empty()) {
+            if (allReservations.empty()) {
                 cout << "\nNo reservations to sort.\n";
                 break;
             }
+            // Sort a copy so the original booking order is kept
+            vector<Reservation> tempReservations = allReservations;
             cout << "\nPerforming Merge Sort on reservations by total price...\n";
             auto start = chrono::high_resolution_clock::now();
             mergeSort(tempReservations); // Calls the wrapper
@@ -822,17 +7112,17 @@ void generateReport() {
             break;
         }
         case 3: { // Linear Search
-            if (allReservations.empty()) {
+            if (allReservations.empty() && coldArchive.reservationCount() == 0) {
                 cout << "\nNo reservations to search.\n";
                 break;
             }
             cout << "\nEnter Reference Number to search (Linear Search):\n";
             cin.ignore(numeric_limits<streamsize>::max(), '\n');
-            getline(cin, searchRefNum);
+            if (!readReferenceNumber(searchKey) || ruledOutByRefFilter(searchKey)) break;
 
             cout << "\nPerforming Linear Search...\n";
             auto start = chrono::high_resolution_clock::now();
-            foundIndex = linearSearch(allReservations, searchRefNum);
+            foundIndex = linearSearch(allReservations, searchKey);
             auto end = chrono::high_resolution_clock::now();
             chrono::duration<double> duration = end - start;
             cout << "Linear Search completed in: " << fixed << setprecision(6) << duration.count() << " seconds.\n";
@@ -841,42 +7131,200 @@ void generateReport() {
                 cout << "Reservation found! Details:\n";
                 displayBoardingPass(allReservations[foundIndex]); // Reuse display for found item
             } else {
-                cout << "Reservation with Reference Number '" << searchRefNum << "' not found.\n";
+                showArchivedReservation(searchKey); // Departed flights live in the cold archive
             }
             break;
         }
         case 4: { // Binary Search
-            if (allReservations.empty()) {
+            if (allReservations.empty() && coldArchive.reservationCount() == 0) {
                 cout << "\nNo reservations to search.\n";
                 break;
             }
             cout << "\nEnter Reference Number to search (Binary Search):\n";
             cin.ignore(numeric_limits<streamsize>::max(), '\n');
-            getline(cin, searchRefNum);
+            if (!readReferenceNumber(searchKey) || ruledOutByRefFilter(searchKey)) break;
+            cout << "Search layout (1 = Sorted array, 2 = Eytzinger layout with prefetch):\n";
+            int layout;
+            cin >> layout;
+            if (cin.fail()) {
+                cin.clear();
+                layout = 1;
+            }
 
-            // Binary search requires sorted data. Sort a copy by reference number.
-            vector<Reservation> sortedByRefNum = allReservations;
-            cout << "\nSorting data for Binary Search...\n";
-            sort(sortedByRefNum.begin(), sortedByRefNum.end(), [](const Reservation& a, const Reservation& b) {
-                return a.referenceNumber < b.referenceNumber;
-            });
-            
-            cout << "Performing Binary Search...\n";
+            // Both indexes are kept up to date, so there is nothing to copy or sort here
+            cout << "\nPerforming Binary Search on the " << (layout == 2 ? "Eytzinger" : "sorted") << " index...\n";
             auto start = chrono::high_resolution_clock::now();
-            foundIndex = binarySearch(sortedByRefNum, searchRefNum);
+            foundIndex = layout == 2 ? findReservationSlotEytzinger(searchKey) : findReservationSlotSorted(searchKey);
             auto end = chrono::high_resolution_clock::now();
             chrono::duration<double> duration = end - start;
             cout << "Binary Search completed in: " << fixed << setprecision(6) << duration.count() << " seconds.\n";
 
             if (foundIndex != -1) {
                 cout << "Reservation found! Details:\n";
-                displayBoardingPass(sortedByRefNum[foundIndex]);
+                displayBoardingPass(allReservations[foundIndex]);
+            } else {
+                showArchivedReservation(searchKey); // Departed flights live in the cold archive
+            }
+            break;
+        }
+        case 5: { // Hash index lookup
+            if (allReservations.empty() && coldArchive.reservationCount() == 0) {
+                cout << "\nNo reservations to search.\n";
+                break;
+            }
+            cout << "\nEnter Reference Number to search (Hash Index):\n";
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            if (!readReferenceNumber(searchKey) || ruledOutByRefFilter(searchKey)) break;
+
+            cout << "\nLooking up the hash index...\n";
+            auto start = chrono::high_resolution_clock::now();
+            foundIndex = findReservationSlot(searchKey); // Maintained on every booking, nothing to prepare
+            auto end = chrono::high_resolution_clock::now();
+            chrono::duration<double> duration = end - start;
+            cout << "Hash lookup completed in: " << fixed << setprecision(6) << duration.count() << " seconds.\n";
+
+            if (foundIndex != -1) {
+                cout << "Reservation found! Details:\n";
+                displayBoardingPass(allReservations[foundIndex]);
+            } else {
+                showArchivedReservation(searchKey);
+            }
+            break;
+        }
+        case 6: { // Vectorized linear scan over the packed keys
+            if (allReservations.empty() && coldArchive.reservationCount() == 0) {
+                cout << "\nNo reservations to search.\n";
+                break;
+            }
+            cout << "\nEnter Reference Number to search (SIMD Linear Scan):\n";
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            if (!readReferenceNumber(searchKey) || ruledOutByRefFilter(searchKey)) break;
+
+            cout << "\nScanning reference keys (" << keyScanKernelName(bestKeyScanKernel()) << " kernel)...\n";
+            auto start = chrono::high_resolution_clock::now();
+            foundIndex = scanReservationSlot(searchKey);
+            auto end = chrono::high_resolution_clock::now();
+            chrono::duration<double> duration = end - start;
+            cout << "SIMD Linear Scan completed in: " << fixed << setprecision(6) << duration.count() << " seconds.\n";
+
+            if (foundIndex != -1) {
+                cout << "Reservation found! Details:\n";
+                displayBoardingPass(allReservations[foundIndex]);
             } else {
-                cout << "Reservation with Reference Number '" << searchRefNum << "' not found.\n";
+                showArchivedReservation(searchKey);
+            }
+            break;
+        }
+        case 7: { // Range scan over the sorted index
+            if (allReservations.empty()) {
+                cout << "\nNo reservations to list.\n";
+                break;
+            }
+            RefKey first, last;
+            cout << "\nEnter first Reference Number of the range (e.g. RBA):\n";
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            if (!readReferenceNumber(first)) break;
+            cout << "Enter last Reference Number of the range (a prefix includes every reference starting with it):\n";
+            string lastText;
+            getline(cin, lastText);
+            if (!RefKey::fromString(lastText, last)) {
+                cout << "'" << lastText << "' is not a valid reference number.\n";
+                break;
+            }
+            if (lastText.size() < 8) last.value |= lastText.empty() ? ~0ull : ~0ull >> (8 * lastText.size()); // Pad with the largest byte
+
+            auto start = chrono::high_resolution_clock::now();
+            vector<size_t> slots = reservationSlotsInRange(first, last);
+            auto end = chrono::high_resolution_clock::now();
+            chrono::duration<double> duration = end - start;
+            cout << "\n" << slots.size() << " reservation(s) found in " << fixed << setprecision(6) << duration.count() << " seconds:\n";
+            for (size_t slot : slots) {
+                const Reservation& res = allReservations[slot];
+                cout << "  Ref: " << res.referenceNumber << ", Dest: " << res.destination << ", Date: " << res.flightDate
+                     << ", Price: RM" << setprecision(2) << res.totalPrice << "\n";
             }
             break;
         }
-        case 5: { // View All Reservations
+        case 8: { // Bitmap index query
+            if (allReservations.empty()) {
+                cout << "\nNo reservations to search.\n";
+                break;
+            }
+            // Reads a comma-separated list of values, upper-cased to match the stored fields
+            auto readValues = []() {
+                string line, value;
+                getline(cin, line);
+                vector<string> values;
+                stringstream stream(line);
+                while (getline(stream, value, ',')) {
+                    value.erase(0, value.find_first_not_of(" \t"));
+                    value.erase(value.find_last_not_of(" \t") + 1);
+                    transform(value.begin(), value.end(), value.begin(), [](unsigned char c) { return static_cast<char>(toupper(c)); });
+                    if (!value.empty()) values.push_back(value);
+                }
+                return values;
+            };
+            auto listValues = [](const vector<string>& values) {
+                string joined;
+                for (const auto& value : values) joined += (joined.empty() ? "" : ", ") + value;
+                return joined;
+            };
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            cout << "\nDestinations (" << listValues(destinationBitmaps.values()) << ")\nEnter one or more, comma-separated (blank = any):\n";
+            vector<string> destinations = readValues();
+            cout << "Departure times (" << listValues(departureBitmaps.values()) << ")\nEnter one or more, comma-separated (blank = any):\n";
+            vector<string> departureTimes = readValues();
+
+            auto start = chrono::high_resolution_clock::now();
+            vector<size_t> slots = findReservationsByFlight(destinations, departureTimes);
+            auto end = chrono::high_resolution_clock::now();
+            chrono::duration<double> duration = end - start;
+            const size_t maxShown = 50;
+            cout << "\n" << slots.size() << " reservation(s) found in " << fixed << setprecision(6) << duration.count() << " seconds"
+                 << (slots.size() > maxShown ? " (showing the first " + to_string(maxShown) + ")" : "") << ":\n";
+            for (size_t i = 0; i < slots.size() && i < maxShown; ++i) {
+                const Reservation& res = allReservations[slots[i]];
+                cout << "  Ref: " << res.referenceNumber << ", Dest: " << res.destination << ", Time: " << res.departureTime
+                     << ", Date: " << res.flightDate << ", Price: RM" << setprecision(2) << res.totalPrice << "\n";
+            }
+            break;
+        }
+        case 9: { // Filter query
+            string text;
+            cout << "\nFields: destination, time, date, price, discount, adults, kids, and passenger age and class."
+                 << "\nCompare with = != < <= > >= or list values with IN (A, B); join conditions with AND.\n"
+                 << "\nEnter query:\n";
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            getline(cin, text);
+            CompiledQuery query;
+            string error;
+            if (!compileQuery(text, query, error)) {
+                cout << "\n\n***** E R R O R *****\nInvalid query: " << error << "\n*********************\n";
+                break;
+            }
+
+            size_t scanned;
+            auto start = chrono::high_resolution_clock::now();
+            vector<size_t> slots = runReservationQuery(query, scanned);
+            auto end = chrono::high_resolution_clock::now();
+            chrono::duration<double> duration = end - start;
+            const size_t maxShown = 50;
+            double totalValue = 0;
+            for (size_t slot : slots) totalValue += allReservations[slot].totalPrice;
+            cout << "\n" << slots.size() << " reservation(s) found in " << fixed << setprecision(6) << duration.count() << " seconds"
+                 << " after testing " << scanned << " of " << allReservations.size()
+                 << (query.never ? " (the conditions contradict each other)" : scanned < allReservations.size() ? " (narrowed by the bitmap indexes)" : "")
+                 << ".\nTotal value: RM" << setprecision(2) << totalValue << "\n";
+            if (slots.size() > maxShown) cout << "Showing the first " << maxShown << ":\n";
+            for (size_t i = 0; i < slots.size() && i < maxShown; ++i) {
+                const Reservation& res = allReservations[slots[i]];
+                cout << "  Ref: " << res.referenceNumber << ", Dest: " << res.destination << ", Time: " << res.departureTime
+                     << ", Date: " << res.flightDate << ", Adults: " << res.numAdults << ", Kids: " << res.numKids
+                     << ", Price: RM" << res.totalPrice << "\n";
+            }
+            break;
+        }
+        case 10: { // View All Reservations
             if (allReservations.empty()) {
                 cout << "\nNo reservations to display.\n";
             } else {
@@ -888,7 +7336,13 @@ void generateReport() {
             }
             break;
         }
-        case 6: // Back to Main Menu
+        case 11: // Performance Benchmarks
+            runBenchmarks();
+            break;
+        case 12: // Streaming report
+            streamReport();
+            break;
+        case 13: // Back to Main Menu
             return;
         default:
             cout << "\nInvalid option. Please try again.\n";
@@ -898,11 +7352,564 @@ void generateReport() {
     clearScreen();
 }
 
+// --- Data Management ---
+
+/**
+ * @brief Shows the booking log's group-commit counters and lets the user retune it.
+ */
+void configureDurability() {
+    GroupCommitSettings settings = bookingLog.getSettings();
+    GroupCommitStats stats = bookingLog.getStats();
+
+    cout << "\n========== D U R A B I L I T Y ==========\n";
+    cout << "\nGroup commit window    : " << settings.window.count() << " us";
+    cout << "\nMax bookings per batch : " << settings.maxBatchRecords;
+    cout << "\n\nBatches committed      : " << stats.batches;
+    cout << "\nBookings committed     : " << stats.records;
+    cout << "\nAverage batch size     : " << fixed << setprecision(2) << stats.averageBatchSize();
+    cout << "\nLargest batch          : " << stats.largestBatch;
+    cout << "\nAverage commit latency : " << setprecision(3) << stats.averageCommitSeconds() * 1000.0 << " ms";
+    cout << "\nSlowest commit         : " << stats.maxCommitSeconds * 1000.0 << " ms";
+    cout << "\nAverage booking wait   : " << stats.averageWaitSeconds() * 1000.0 << " ms";
+
+    cout << "\n\nEnter new window in microseconds (-1 = keep current):\n";
+    long long window;
+    cin >> window;
+    if (cin.fail()) {
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    } else if (window >= 0) {
+        settings.window = chrono::microseconds(window);
+    }
+    cout << "\nEnter new max bookings per batch (0 = keep current):\n";
+    long long maxBatch;
+    cin >> maxBatch;
+    if (cin.fail()) {
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    } else if (maxBatch > 0) {
+        settings.maxBatchRecords = static_cast<size_t>(maxBatch);
+    }
+    bookingLog.setSettings(settings);
+    cout << "\nDurability settings updated.\n";
+}
+
+/**
+ * @brief Shows background checkpoint activity and lets the user retune its triggers.
+ */
+void configureCheckpoints() {
+    CheckpointSettings settings = checkpointer.getSettings();
+    CheckpointStats stats = checkpointer.getStats();
+
+    cout << "\n========== C H E C K P O I N T S ==========\n";
+    cout << "\nCheckpoint when log reaches : " << settings.maxLogBytes << " bytes";
+    cout << "\nCheckpoint at least every   : " << settings.maxInterval.count() << " seconds";
+    cout << "\n\nCurrent booking log size    : " << bookingLog.sizeBytes() << " bytes";
+    cout << "\nBackground checkpoints      : " << stats.checkpoints << " (" << stats.failures << " failed)";
+    cout << "\nLast checkpoint trigger     : " << stats.lastTrigger;
+    cout << "\nLast checkpoint duration    : " << fixed << setprecision(3) << stats.lastDurationSeconds * 1000.0 << " ms";
+
+    cout << "\n\nEnter new log size trigger in bytes (0 = keep current):\n";
+    long long maxLogBytes;
+    cin >> maxLogBytes;
+    if (cin.fail()) {
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    } else if (maxLogBytes > 0) {
+        settings.maxLogBytes = static_cast<uint64_t>(maxLogBytes);
+    }
+    cout << "\nEnter new time trigger in seconds (0 = keep current):\n";
+    long long maxInterval;
+    cin >> maxInterval;
+    if (cin.fail()) {
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    } else if (maxInterval > 0) {
+        settings.maxInterval = chrono::seconds(maxInterval);
+    }
+    checkpointer.setSettings(settings);
+    cout << "\nCheckpoint settings updated.\n";
+}
+
+/**
+ * @brief Shows how well the reference filter screens out unknown reference numbers and lets the
+ * user resize it.
+ */
+void configureRefFilter() {
+    RefFilterStats stats = getRefFilterStats();
+
+    cout << "\n========== R E F E R E N C E   F I L T E R ==========\n";
+    cout << "\nBits per reference number     : " << stats.bitsPerKey << " (" << stats.hashCount << " probes per lookup)";
+    cout << "\nReference numbers held        : " << stats.keys << " of " << stats.capacity << " before it grows";
+    cout << "\nFilter size                   : " << stats.memoryBytes / 1024 << " KB";
+    cout << "\nEstimated false-positive rate : " << fixed << setprecision(3) << stats.estimatedFalsePositiveRate * 100.0 << " %";
+    cout << "\n\nUnknown references rejected   : " << stats.rejections;
+    cout << "\nUnknown references let through: " << stats.falsePositives;
+    cout << "\nObserved false-positive rate  : " << stats.observedFalsePositiveRate() * 100.0 << " %";
+
+    cout << "\n\nEnter new bits per reference number (0 = keep current):\n";
+    long long bitsPerKey;
+    cin >> bitsPerKey;
+    if (cin.fail()) {
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    } else if (bitsPerKey > 0 && bitsPerKey <= 64 && static_cast<uint32_t>(bitsPerKey) != stats.bitsPerKey) {
+        resizeRefFilter(static_cast<uint32_t>(bitsPerKey));
+        stats = getRefFilterStats();
+        cout << "\nReference filter rebuilt: " << stats.memoryBytes / 1024 << " KB, estimated false-positive rate "
+             << stats.estimatedFalsePositiveRate * 100.0 << " %.\n";
+    }
+}
+
+/**
+ * @brief Lets the user import or export reservations in the text format and tune durability.
+ * The binary snapshot stays the primary store; this menu exists for moving data in and out.
+ */
+void manageData() {
+    cout << "\n========== D A T A   M A N A G E M E N T ==========\n";
+    cout << "\n1. Export reservations to text file";
+    cout << "\n2. Import reservations from file (text or binary snapshot)";
+    cout << "\n3. Export reservations to columnar analytics file";
+    cout << "\n4. Revenue by destination from columnar file";
+    cout << "\n5. Archive departed flights";
+    cout << "\n6. Durability settings (group commit)";
+    cout << "\n7. Checkpoint settings";
+    cout << "\n8. Reference filter (Bloom filter) statistics and size";
+    cout << "\n9. Back to Main Menu";
+    cout << "\n\nChoose an option:\n";
+
+    int dataChoice;
+    cin >> dataChoice;
+    if (cin.fail()) {
+        cin.clear();
+        dataChoice = 0;
+    }
+    clearScreen();
+
+    string filename;
+    switch (dataChoice) {
+        case 1: {
+            cout << "\nEnter file name to export to (blank = " << TEXT_FILE << "):\n";
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            getline(cin, filename);
+            if (filename.empty()) filename = TEXT_FILE;
+            saveReservations(allReservations, filename, StorageFormat::Text);
+            cout << "\nExported " << allReservations.size() << " reservations to " << filename << ".\n";
+            break;
+        }
+        case 2: {
+            cout << "\nEnter file name to import from (blank = " << TEXT_FILE << "):\n";
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            getline(cin, filename);
+            if (filename.empty()) filename = TEXT_FILE;
+            vector<Reservation> imported = loadReservations(filename);
+            addReservationsUnlogged(imported);
+            checkpointReservations(); // One snapshot write instead of logging every imported booking
+            cout << "\nImported " << imported.size() << " reservations from " << filename << ".\n";
+            break;
+        }
+        case 3: {
+            cout << "\nEnter file name to export to (blank = " << COLUMNAR_FILE << "):\n";
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            getline(cin, filename);
+            if (filename.empty()) filename = COLUMNAR_FILE;
+            if (writeColumnar(allReservations, filename)) {
+                cout << "\nExported " << allReservations.size() << " reservations to " << filename << ".\n";
+            }
+            break;
+        }
+        case 4: {
+            cout << "\nEnter columnar file to analyse (blank = " << COLUMNAR_FILE << "):\n";
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            getline(cin, filename);
+            if (filename.empty()) filename = COLUMNAR_FILE;
+            columnarRevenueByDestination(filename);
+            break;
+        }
+        case 5: {
+            size_t moved = archiveDepartedFlights();
+            cout << "\nMoved " << moved << " reservations for departed flights to " << ARCHIVE_FILE << ".\n";
+            error_code ec;
+            uint64_t archiveBytes = filesystem::file_size(ARCHIVE_FILE, ec);
+            cout << "The archive holds " << coldArchive.reservationCount() << " reservations in " << coldArchive.blockCount()
+                 << " blocks (" << (ec ? 0 : archiveBytes) << " bytes); " << allReservations.size() << " remain active.\n";
+            break;
+        }
+        case 6:
+            configureDurability();
+            break;
+        case 7:
+            configureCheckpoints();
+            break;
+        case 8:
+            configureRefFilter();
+            break;
+        case 9:
+            return;
+        default:
+            cout << "\nInvalid option. Please try again.\n";
+            break;
+    }
+    pressAnyKey();
+}
+
+// --- Lookup-Only Mode ---
+
+/**
+ * @brief Prints a reservation as plain text, without clearing the screen or pausing.
+ * @param res The reservation to print.
+ */
+void printReservation(const Reservation& res) {
+    cout << "Reference Number : " << res.referenceNumber << "\n";
+    cout << "Flight           : KUALA LUMPUR to " << res.destination << "  " << res.departureTime << "  " << res.flightDate << "\n";
+    for (const auto& p : res.passengers) {
+        cout << "  " << left << setw(28) << p.name << right << " Age " << setw(3) << p.age
+             << "  Seat " << setw(2) << p.seatNumber << "  " << p.travelClass << "\n";
+    }
+    cout << "Total Amount     : RM" << fixed << setprecision(2) << res.totalPrice << "\n";
+}
+
+/**
+ * @brief Finds one reservation on disk without loading the store.
+ * The reference index is binary-searched through its mapping and only the matching snapshot
+ * record is read, so a lookup costs a handful of page faults. Without a current index the snapshot
+ * records are scanned in place instead.
+ * Bookings still in the booking log are newer than the snapshot and take precedence; reservations
+ * for departed flights are looked up in the cold archive. When the reference filter covers the
+ * snapshot and archive and rules the reference out, neither of them is touched.
+ * @param refNum The reference number to look for.
+ * @param found Receives the newest version of the reservation.
+ * @return True if the reservation exists.
+ */
+bool lookupReservation(RefKey refNum, Reservation& found) {
+    bool located = false;
+    uint64_t walSequence = 0;
+    RefFilterView filter;
+    bool persisted = !filter.open(REF_FILTER_FILE) || !filter.covers(currentRefFilterCoverage()) || filter.mightContain(refNum);
+    RefIndexView index;
+    MappedFile snapshot;
+    error_code ec;
+    uint64_t snapshotBytes = filesystem::file_size(SNAPSHOT_FILE, ec);
+    if (!persisted) {
+        // Ruled out by the filter, so only the booking log can hold it. Replaying all of the log is
+        // safe: a record already folded into the snapshot would have passed the filter.
+    } else if (!ec && index.open(REF_INDEX_FILE) && index.coveredBytes() == snapshotBytes &&
+        snapshot.open(SNAPSHOT_FILE)) {
+        walSequence = index.walSequence();
+        vector<RefIndexHit> hits = index.find(refNum.value);
+        for (auto hit = hits.rbegin(); hit != hits.rend() && !located; ++hit) {
+            SnapshotSegment segment;
+            string error;
+            if (!mapSnapshotSegment(snapshot, hit->segmentOffset, segment, error)) continue;
+            uint64_t recordBase = segment.fileOffset + segment.header->reservationOffset;
+            if (hit->recordOffset < recordBase) continue;
+            uint64_t i = (hit->recordOffset - recordBase) / sizeof(ReservationRecord);
+            if (i >= segment.reservationCount() || !segment.verify(i) ||
+                segment.reservations[i].referenceKey != refNum.value) {
+                continue;
+            }
+            found = segment.materialize(i);
+            located = true;
+        }
+    } else if (isBinarySnapshot(SNAPSHOT_FILE)) {
+        SnapshotView view;
+        string error;
+        if (view.open(SNAPSHOT_FILE, error)) {
+            walSequence = view.walSequence();
+            for (const auto& segment : view.getSegments()) {
+                for (size_t i = 0; i < segment.reservationCount(); ++i) {
+                    if (segment.reservations[i].referenceKey == refNum.value && segment.verify(i)) {
+                        found = segment.materialize(i); // Later segments supersede earlier ones
+                        located = true;
+                    }
+                }
+            }
+        }
+    }
+
+    vector<Reservation> logged;
+    uint64_t validBytes;
+    replayBookingLog(WAL_FILE, walSequence, logged, validBytes);
+    for (const auto& res : logged) {
+        if (res.referenceNumber == refNum) {
+            found = res;
+            located = true;
+        }
+    }
+    if (!located && persisted) {
+        ColdArchive archive; // Departed flights
+        located = archive.open(ARCHIVE_FILE) && archive.find(refNum, found);
+    }
+    return located;
+}
+
+/**
+ * @brief Answers reference number queries from the command line and exits.
+ * Usage: program --lookup REF [REF...]
+ * @param count Number of reference numbers.
+ * @param refs The reference numbers.
+ * @return Process exit code: 0 if every reservation was found, 1 otherwise, 2 on bad usage.
+ */
+int runLookupOnly(int count, char* refs[]) {
+    if (count == 0) {
+        cerr << "Usage: --lookup REFERENCE_NUMBER [REFERENCE_NUMBER...]\n";
+        return 2;
+    }
+    int missing = 0;
+    for (int i = 0; i < count; ++i) {
+        Reservation res;
+        RefKey key;
+        if (i > 0) cout << "\n";
+        if (RefKey::fromString(refs[i], key) && lookupReservation(key, res)) {
+            printReservation(res);
+        } else {
+            cout << "Reservation " << refs[i] << " not found.\n";
+            ++missing;
+        }
+    }
+    return missing == 0 ? 0 : 1;
+}
+
+/**
+ * @brief Checks a list of reference numbers against the store and exits.
+ * Usage: program --reconcile FILE (one reference number per line, "-" reads standard input).
+ * Prints one line per reference, in input order: the reference and ACTIVE, ARCHIVED, NOT FOUND or
+ * INVALID, followed by a summary line.
+ * @param filename The list to check.
+ * @return Process exit code: 0 if every reservation was found, 1 otherwise, 2 if the list or the store cannot be read.
+ */
+int runReconcile(const string& filename) {
+    ifstream inFile;
+    if (filename != "-") {
+        inFile.open(filename);
+        if (!inFile.is_open()) {
+            cerr << "Error: Could not open file " << filename << " for reading.\n";
+            return 2;
+        }
+    }
+    istream& in = filename == "-" ? cin : inFile;
+    vector<string> lines;
+    vector<RefKey> refs;
+    vector<bool> valid;
+    string line;
+    while (getline(in, line)) {
+        line.erase(line.find_last_not_of(" \t\r") + 1);
+        if (line.empty()) continue;
+        RefKey key;
+        valid.push_back(RefKey::fromString(line, key));
+        refs.push_back(key);
+        lines.push_back(line);
+    }
+
+    if (!loadStore(true)) { // The interactive program may be running on the same files
+        cerr << "Error: The reservation store could not be read; nothing was reconciled.\n";
+        return 2;
+    }
+    vector<int> slots = findReservationSlots(refs);
+    size_t active = 0, archived = 0, missing = 0;
+    Reservation res;
+    for (size_t i = 0; i < refs.size(); ++i) {
+        const char* status;
+        if (!valid[i]) {
+            status = "INVALID";
+            ++missing;
+        } else if (slots[i] != -1) {
+            status = "ACTIVE";
+            ++active;
+        } else if (referenceMayExist(refs[i]) && coldArchive.find(refs[i], res)) {
+            status = "ARCHIVED";
+            ++archived;
+        } else {
+            status = "NOT FOUND";
+            ++missing;
+        }
+        cout << lines[i] << "\t" << status << "\n";
+    }
+    cout << refs.size() << " checked: " << active << " active, " << archived << " archived, " << missing << " not found\n";
+    return missing == 0 ? 0 : 1;
+}
+
+// --- Self-Test ---
+
+// Encodes a list of reservations in the booking-log format; two lists hold the same data exactly when these match
+string encodeReservations(const vector<Reservation>& reservations) {
+    string out;
+    for (const auto& res : reservations) encodeReservation(res, out);
+    return out;
+}
+
+/**
+ * @brief Checks crash recovery of the snapshot and the booking log, then exits.
+ * Usage: program --self-test
+ * Each case writes scratch files in a temporary directory, cuts or damages them the way a crash
+ * would, reloads them and compares the result with what has to survive. The store's own files are
+ * not touched.
+ * @return Process exit code: 0 if every case passed, 1 otherwise.
+ */
+int runSelfTest() {
+    error_code ec;
+    mt19937 rng(2024);
+    filesystem::path dir = filesystem::temp_directory_path(ec) / ("airline-self-test-" + to_string(random_device{}()));
+    if (ec || !filesystem::create_directories(dir, ec)) {
+        cerr << "Error: Could not create a scratch directory for the self-test.\n";
+        return 1;
+    }
+    const string logFile = (dir / "selftest.wal").string();
+    const string snapshotFile = (dir / "selftest.dat").string();
+    const string rewrittenFile = (dir / "selftest-full.dat").string();
+
+    vector<Reservation> bookings;
+    for (int i = 0; i < 120; ++i) bookings.push_back(makeSyntheticReservation(rng));
+    auto firstBookings = [&](size_t count) { return vector<Reservation>(bookings.begin(), bookings.begin() + count); };
+
+    int failures = 0;
+    auto check = [&](const string& name, bool passed) {
+        cout << (passed ? "PASS  " : "FAIL  ") << name << "\n";
+        if (!passed) ++failures;
+    };
+    auto loadSnapshot = [](const string& filename, vector<Reservation>& loaded, SnapshotInfo& info) {
+        string error;
+        loaded.clear();
+        return readSnapshot(filename, loaded, info, error);
+    };
+
+    // 1. A crash while the last booking was being written leaves a torn record at the end of the log
+    {
+        BookingLog log;
+        bool ok = log.open(logFile, 0, 0);
+        for (size_t i = 0; i < 20 && ok; ++i) ok = log.append(bookings[i]) == i + 1;
+        log.close();
+        uintmax_t fullBytes = filesystem::file_size(logFile, ec);
+        filesystem::resize_file(logFile, fullBytes - 5, ec);
+        vector<Reservation> replayed;
+        uint64_t validBytes;
+        uint64_t lastSequence = replayBookingLog(logFile, 0, replayed, validBytes);
+        check("torn log tail: complete bookings are replayed",
+              ok && !ec && lastSequence == 19 && encodeReservations(replayed) == encodeReservations(firstBookings(19)));
+
+        ok = log.open(logFile, validBytes, lastSequence) && log.append(bookings[19]) == 20;
+        log.close();
+        replayed.clear();
+        lastSequence = replayBookingLog(logFile, 0, replayed, validBytes);
+        check("torn log tail: the next booking overwrites the torn record",
+              ok && lastSequence == 20 && encodeReservations(replayed) == encodeReservations(firstBookings(20)));
+    }
+
+    // 2. A delta segment cut short or damaged is ignored; the snapshot before it still loads
+    vector<Reservation> expected = firstBookings(100);
+    vector<Reservation> changed;
+    vector<uint64_t> slots;
+    for (uint64_t slot : { 3, 50, 99 }) {
+        expected[slot].totalPrice += 100.0;
+        changed.push_back(expected[slot]);
+        slots.push_back(slot);
+    }
+    for (size_t i = 100; i < 110; ++i) {
+        expected.push_back(bookings[i]);
+        changed.push_back(bookings[i]);
+        slots.push_back(i);
+    }
+    {
+        vector<Reservation> loaded;
+        SnapshotInfo info;
+        uint64_t segmentBytes = 0;
+        bool ok = writeSnapshot(firstBookings(100), snapshotFile, 100);
+        uintmax_t fullBytes = filesystem::file_size(snapshotFile, ec);
+        ok = ok && appendSnapshotDelta(changed, slots, snapshotFile, 110, fullBytes, segmentBytes);
+        filesystem::resize_file(snapshotFile, fullBytes + segmentBytes - 8, ec);
+        ok = ok && !ec && loadSnapshot(snapshotFile, loaded, info);
+        check("torn delta segment: the full segment still loads",
+              ok && info.validBytes == fullBytes && info.walSequence == 100 &&
+              encodeReservations(loaded) == encodeReservations(firstBookings(100)));
+
+        ok = appendSnapshotDelta(changed, slots, snapshotFile, 110, info.validBytes, segmentBytes) &&
+             loadSnapshot(snapshotFile, loaded, info);
+        check("torn delta segment: the next delta overwrites it",
+              ok && info.walSequence == 110 && encodeReservations(loaded) == encodeReservations(expected));
+
+        fstream file(snapshotFile, ios::in | ios::out | ios::binary);
+        file.seekp(fullBytes + sizeof(SnapshotHeader)); // First record of the delta
+        file.put('\x5A');
+        file.close();
+        ok = loadSnapshot(snapshotFile, loaded, info);
+        check("damaged delta record: loading stops before it",
+              ok && info.damaged && encodeReservations(loaded) == encodeReservations(firstBookings(100)));
+    }
+
+    // 3. A crash after the snapshot was written but before the log was compacted: the log still
+    //    holds bookings the snapshot has, and replay must not add them twice
+    {
+        filesystem::remove(logFile, ec);
+        BookingLog log;
+        bool ok = log.open(logFile, 0, 0);
+        for (size_t i = 0; i < 30 && ok; ++i) ok = log.append(bookings[i]) == i + 1;
+        ok = ok && writeSnapshot(firstBookings(20), snapshotFile, 20);
+        auto reload = [&](vector<Reservation>& loaded) {
+            SnapshotInfo info;
+            uint64_t validBytes;
+            return loadSnapshot(snapshotFile, loaded, info) &&
+                   replayBookingLog(logFile, info.walSequence, loaded, validBytes) == 30;
+        };
+        vector<Reservation> loaded;
+        ok = ok && reload(loaded);
+        check("crash before compaction: each booking is loaded once",
+              ok && encodeReservations(loaded) == encodeReservations(firstBookings(30)));
+
+        ok = log.compact(20) && reload(loaded);
+        log.close();
+        check("crash before compaction: compacting later keeps the newer bookings",
+              ok && encodeReservations(loaded) == encodeReservations(firstBookings(30)));
+    }
+
+    // 4. A full segment plus deltas and the full rewrite made from them hold the same reservations
+    {
+        vector<Reservation> loaded, rewritten;
+        SnapshotInfo info, rewrittenInfo;
+        uint64_t segmentBytes;
+        bool ok = writeSnapshot(firstBookings(100), snapshotFile, 100) &&
+                  appendSnapshotDelta(changed, slots, snapshotFile, 110, filesystem::file_size(snapshotFile, ec), segmentBytes) &&
+                  loadSnapshot(snapshotFile, loaded, info) && writeSnapshot(loaded, rewrittenFile, info.walSequence) &&
+                  loadSnapshot(rewrittenFile, rewritten, rewrittenInfo);
+        check("delta then full rewrite: both load the same reservations",
+              ok && info.deltaSegments == 1 && rewrittenInfo.deltaSegments == 0 && rewrittenInfo.walSequence == 110 &&
+              encodeReservations(loaded) == encodeReservations(expected) &&
+              encodeReservations(rewritten) == encodeReservations(expected));
+    }
+
+    filesystem::remove_all(dir, ec);
+    cout << (failures == 0 ? "All self-test cases passed.\n" : to_string(failures) + " self-test case(s) failed.\n");
+    return failures == 0 ? 0 : 1;
+}
+
 // --- Main Program Loop ---
 
-int main() {
+/**
+ * @brief Records a booking and shows its boarding pass, or an error if it could not be saved.
+ * @param res The new reservation.
+ */
+void bookAndShowBoardingPass(const Reservation& res) {
+    if (addReservation(res)) {
+        displayBoardingPass(res);
+    } else {
+        cout << "\n\n***** E R R O R *****\nThe booking could not be saved, so it was not made. Please try again.\n*********************\n";
+        pressAnyKey();
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc >= 2 && string(argv[1]) == "--lookup") {
+        return runLookupOnly(argc - 2, argv + 2); // Answer from the files on disk without loading the store
+    }
+    if (argc == 3 && string(argv[1]) == "--reconcile") {
+        return runReconcile(argv[2]);
+    }
+    if (argc == 2 && string(argv[1]) == "--self-test") {
+        return runSelfTest();
+    }
     srand(time(0)); // Seed the random number generator for reference IDs
-    allReservations = loadReservations(); // Load existing reservations when program starts
+    loadStore(); // Load existing reservations (snapshot + booking log) when program starts
+    archiveDepartedFlights(); // Keep only upcoming flights in the active set
+    checkpointer.start();
 
     int choice1; // Main menu choice
     do {
@@ -920,12 +7927,16 @@ int main() {
         cout << "  3. Coupons\n";
         cout << "  4. Report & DSA Analysis\n"; // Renamed for clarity
         cout << "  5. Credits\n";
-        cout << "  6. Exit\n";
+        cout << "  6. Data Management\n";
+        cout << "  7. Reprint Boarding Pass\n";
+        cout << "  8. Passenger Name Search\n";
+        cout << "  9. Seat Lookup & Cabin Manifest\n";
+        cout << "  10. Exit\n";
         cout << "  ";
 
         cin >> choice1;
-        while (cin.fail() || choice1 < 1 || choice1 > 6) {
-            cout << "\n\n***** E R R O R *****\nInvalid option chosen (1-6 only)\n*********************\n";
+        while (cin.fail() || choice1 < 1 || choice1 > 10) {
+            cout << "\n\n***** E R R O R *****\nInvalid option chosen (1-10 only)\n*********************\n";
             cin.clear();
             cin.ignore(numeric_limits<streamsize>::max(), '\n');
             cout << "  ";
@@ -952,15 +7963,13 @@ int main() {
                 cin >> package;
                 package = toupper(package);
                 if (package == 'A' || package == 'B' || package == 'C') {
-                    allReservations.push_back(createPackageReservation(package));
-                    displayBoardingPass(allReservations.back()); // Display the last added reservation's boarding pass
+                    bookAndShowBoardingPass(createPackageReservation(package));
                 } else if (package != 'M') {
                     cout << "\n\n***** E R R O R *****\nChoose (A / B / C) for the packages OR (M = Main Menu) only\n*********************\n";
                 }
             } while (package != 'A' && package != 'B' && package != 'C' && package != 'M');
         } else if (choice1 == 2) { // MANUAL RESERVATION
-            allReservations.push_back(createManualReservation());
-            displayBoardingPass(allReservations.back()); // Display the last added reservation's boarding pass
+            bookAndShowBoardingPass(createManualReservation());
         } else if (choice1 == 3) { // COUPONS
             cout << "\n========== C O U P O N S ==========\n\nApply one of these coupons in Manual Reservation only\n\n";
             cout << "  - CAPTAINAFIQ   (5% OFF)\n";
@@ -977,10 +7986,146 @@ int main() {
             cout << "    3. Muhammad Amir Iqbal Bin Mohd Tarmidzi\n";
             cout << "    4. Nur Ameerul Ameen Bin Nor Hassan\n";
             pressAnyKey();
+        } else if (choice1 == 6) { // DATA MANAGEMENT
+            manageData();
+        } else if (choice1 == 7) { // REPRINT BOARDING PASS
+            string refNum;
+            cout << "\n========== R E P R I N T ==========\n\nEnter Reference Number:\n";
+            cin >> refNum;
+            RefKey key;
+            bool possible = RefKey::fromString(refNum, key) && referenceMayExist(key); // Typos rarely pass the filter
+            int slot = possible ? findReservationSlot(key) : -1;
+            Reservation archived;
+            if (slot != -1) {
+                displayBoardingPass(allReservations[slot]);
+            } else if (possible && coldArchive.find(key, archived)) { // Departed flight
+                displayBoardingPass(archived);
+            } else {
+                if (possible) noteRefFilterFalsePositive();
+                cout << "\nReservation with Reference Number '" << refNum << "' not found.\n";
+                pressAnyKey();
+            }
+        } else if (choice1 == 8) { // PASSENGER NAME SEARCH
+            const size_t maxShown = 50;
+            string name;
+            cout << "\n========== P A S S E N G E R   S E A R C H ==========\n\nEnter passenger name"
+                 << " (end with * to search by prefix, start with ~ for a typo-tolerant search):\n";
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            getline(cin, name);
+            bool fuzzy = !name.empty() && name.front() == '~';
+            if (fuzzy) name.erase(0, 1);
+            bool prefix = !fuzzy && !name.empty() && name.back() == '*';
+            if (prefix) name.pop_back();
+
+            auto start = chrono::high_resolution_clock::now();
+            vector<PassengerMatch> matches;
+            vector<FuzzyNameMatch> similar;
+            if (!fuzzy) matches = findPassengersByName(name, prefix, maxShown + 1);
+            if (matches.empty() && !prefix) { // The spelling at the counter often differs from the booking
+                similar = findPassengerNamesFuzzy(name, 2, 10);
+                for (const auto& candidate : similar) {
+                    vector<PassengerMatch> more = findPassengersByName(candidate.name, false, maxShown + 1 - matches.size());
+                    matches.insert(matches.end(), more.begin(), more.end());
+                    if (matches.size() > maxShown) break;
+                }
+            }
+            chrono::duration<double, milli> duration = chrono::high_resolution_clock::now() - start;
+            if (matches.empty()) {
+                cout << "\nNo upcoming booking has a passenger named '" << name << (prefix ? "*" : "") << "'.\n";
+            } else {
+                if (!similar.empty()) {
+                    cout << "\n" << (fuzzy ? "Closest" : "No exact match. Closest") << " passenger names:\n";
+                    for (const auto& candidate : similar) {
+                        cout << "  " << left << setw(28) << candidate.name << right << "(" << candidate.distance << " edit"
+                             << (candidate.distance == 1 ? "" : "s") << ")\n";
+                    }
+                }
+                cout << "\n" << (matches.size() > maxShown ? "More than " + to_string(maxShown) : to_string(matches.size()))
+                     << " passenger(s) found in " << fixed << setprecision(3) << duration.count() << " ms:\n\n";
+                for (size_t i = 0; i < matches.size() && i < maxShown; ++i) {
+                    const Reservation& res = allReservations[matches[i].reservation];
+                    const Passenger& p = res.passengers[matches[i].passenger];
+                    cout << "  " << left << setw(10) << res.referenceNumber.toString() << setw(28) << p.name << right
+                         << "Seat " << setw(2) << p.seatNumber << "  " << res.destination << " " << res.flightDate << " "
+                         << res.departureTime << "\n";
+                }
+            }
+            pressAnyKey();
+        } else if (choice1 == 9) { // SEAT LOOKUP & CABIN MANIFEST
+            auto upper = [](string value) {
+                transform(value.begin(), value.end(), value.begin(), [](unsigned char c) { return static_cast<char>(toupper(c)); });
+                return value;
+            };
+            string destination, departureTime, flightDate;
+            int seat;
+            cout << "\n========== S E A T   L O O K U P ==========\n\nEnter destination (e.g. LONDON):\n";
+            cin >> destination;
+            cout << "\nEnter departure time (8.00AM / 1.30PM / 5.00PM / 10.30PM):\n";
+            cin >> departureTime;
+            cout << "\nEnter flight date (YYYY-MM-DD, today is " << todayDate() << "):\n";
+            cin >> flightDate;
+            while (!isValidFlightDate(flightDate)) {
+                cout << "\n\n***** E R R O R *****\nEnter the date as YYYY-MM-DD\n*********************\n";
+                cin >> flightDate;
+            }
+            cout << "\nEnter seat number (1-81), or 0 for the cabin manifest:\n";
+            cin >> seat;
+            while (cin.fail() || seat < 0 || seat > SEATS_PER_FLIGHT) {
+                cout << "\n\n***** E R R O R *****\nSeats on this flight are 1-81 only\n*********************\nChoose a seat, or 0 for the cabin manifest\n";
+                cin.clear();
+                cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                cin >> seat;
+            }
+            destination = upper(destination);
+            departureTime = upper(departureTime);
+            string flight = "KUALA LUMPUR to " + destination + "  " + departureTime + "  " + flightDate;
+            auto printSeat = [](int number, uint32_t slot, uint32_t passenger) {
+                const Reservation& res = allReservations[slot];
+                const Passenger& p = res.passengers[passenger];
+                cout << "  Seat " << setw(2) << number << "  " << left << setw(10) << res.referenceNumber.toString() << setw(28) << p.name
+                     << right << "Age " << setw(3) << p.age << "  " << p.travelClass << "\n";
+            };
+            clearScreen();
+
+            auto start = chrono::high_resolution_clock::now();
+            if (seat != 0) {
+                vector<PassengerMatch> holders = findSeatHolders(flightDate, destination, departureTime, seat);
+                chrono::duration<double, milli> duration = chrono::high_resolution_clock::now() - start;
+                cout << "\n" << flight << "  (looked up in " << fixed << setprecision(3) << duration.count() << " ms)\n\n";
+                if (holders.empty()) cout << "Seat " << seat << " is free.\n";
+                for (const auto& holder : holders) printSeat(seat, static_cast<uint32_t>(holder.reservation), static_cast<uint32_t>(holder.passenger));
+                if (holders.size() > 1) cout << "\nSeat " << seat << " is double booked.\n";
+            } else {
+                FlightSeats seats;
+                bool booked = findFlightSeats(flightDate, destination, departureTime, seats);
+                chrono::duration<double, milli> duration = chrono::high_resolution_clock::now() - start;
+                if (!booked) {
+                    cout << "\nNobody is booked on " << flight << ".\n";
+                } else {
+                    cout << "\n========== C A B I N   M A N I F E S T ==========\n\n" << flight << "\n" << seats.occupied << " of "
+                         << SEATS_PER_FLIGHT << " seats taken (looked up in " << fixed << setprecision(3) << duration.count() << " ms)\n\n";
+                    string freeSeats;
+                    for (int number = 1; number <= SEATS_PER_FLIGHT; ++number) {
+                        const SeatOccupant& occupant = seats.seats[number - 1];
+                        if (occupant.isEmpty()) {
+                            freeSeats += (freeSeats.empty() ? "" : ", ") + to_string(number);
+                        } else {
+                            printSeat(number, occupant.reservation, occupant.passenger);
+                        }
+                    }
+                    if (!seats.doubleBooked.empty()) {
+                        cout << "\nDouble bookings (seat already taken when booked):\n";
+                        for (const auto& extra : seats.doubleBooked) printSeat(extra.first, extra.second.reservation, extra.second.passenger);
+                    }
+                    cout << "\nFree seats: " << (freeSeats.empty() ? "none" : freeSeats) << "\n";
+                }
+            }
+            pressAnyKey();
         }
-    } while (choice1 != 6); // EXIT
+    } while (choice1 != 10); // EXIT
 
-    saveReservations(allReservations); // Save all reservations before exiting
+    checkpointer.stop();
+    checkpointReservations(); // Fold the booking log into a fresh snapshot before exiting
     cout << "\nThank you for using RAUB AIRLINE Reservation System. Goodbye!\n";
     return 0;
 }